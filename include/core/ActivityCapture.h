@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "utils/LogHistogram.h"
+#include "utils/SpscRingBuffer.h"
+
+class QTimer;
+
+/**
+ * @brief 活动采集工作对象
+ * 
+ * 运行在独立的采集线程中，通过 InputSource 后端读取输入计数与活跃窗口，
+ * 将定长采样写入无锁环形缓冲区，由 GUI 线程中的 ActivityMonitor 批量取出。
+ * 用户空闲时按空闲时长将采样间隔从 1 秒逐级退避到 60 秒，有输入时立即恢复；
+ * 后端支持空闲报警时，越过空闲阈值后完全停止采样，直到后端通知恢复活跃。
+ */
+class ActivityCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Sample {
+        qint64 timestampMs = 0;  // 采样时间（Unix 毫秒）
+        int mouseClicks = 0;     // 累计鼠标点击次数
+        int keystrokes = 0;      // 累计键盘输入次数
+        int motionEvents = 0;    // 累计鼠标移动事件数
+        double pointerDistance = 0.0; // 累计指针移动距离（像素）
+        int wheelTicks = 0;      // 累计滚轮格数
+        quint32 windowTitleId = 0; // 活跃窗口标题 ID（StringInternPool::titles()）
+        quint32 applicationId = 0; // 活跃窗口所属应用程序 ID（StringInternPool::applications()）
+        LogHistogram keyIntervals; // 累计按键间隔分布
+    };
+
+    using SampleRing = SpscRingBuffer<Sample, 1024>;
+
+    /**
+     * @brief ring 由 ActivityMonitor 持有，采集对象只作为生产者写入
+     * 
+     * displayName 非空时只使用连接到该 X 显示的 x11 后端
+     */
+    explicit ActivityCapture(SampleRing* ring, const QString& displayName = QString(), QObject *parent = nullptr);
+    ~ActivityCapture();
+
+    /**
+     * @brief 缓冲区已满而丢弃的采样数
+     */
+    quint64 overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 成功写入缓冲区的采样数
+     */
+    quint64 samplesCaptured() const { return m_samplesCaptured.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 观察到的最大队列深度
+     */
+    int maxQueueDepth() const { return m_maxQueueDepth.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 当前采样间隔（毫秒）
+     */
+    int samplingIntervalMs() const { return m_samplingIntervalMs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 相对固定 1 秒采样累计节省的唤醒次数，包括轮询后端的空闲退避和空闲、锁屏时的暂停
+     */
+    quint64 wakeupsSaved() const { return m_wakeupsSaved.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 指定监测的 X 显示，须在采集线程启动前调用
+     */
+    void setDisplayName(const QString& displayName) { m_displayName = displayName; }
+
+    /**
+     * @brief 输入后端是否在越过空闲阈值时主动通知（此时无需按采样判断空闲）
+     */
+    bool hasIdleNotifications() const { return m_idleNotifications.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 活跃窗口是否全屏（缓存值，任意线程可读）
+     */
+    bool isFullscreenActive() const { return m_fullscreen.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 屏幕是否已锁定（缓存值，任意线程可读）
+     */
+    bool isScreenLocked() const { return m_screenLocked.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 消费者取空缓冲区后调用，允许再次发出 samplesAvailable
+     */
+    void acknowledgeSamples() { m_notifyPending.store(false, std::memory_order_release); }
+
+public slots:
+    /**
+     * @brief 在采集线程中初始化平台钩子，须在线程启动后调用
+     */
+    void initialize();
+
+    void start();
+    void stop();
+
+    /**
+     * @brief 设置空闲阈值（毫秒），须在采集线程中调用
+     */
+    void setIdleThreshold(int thresholdMs);
+
+signals:
+    /**
+     * @brief 缓冲区中有新采样时发出（合并通知，取空前只发一次）
+     */
+    void samplesAvailable();
+
+    /**
+     * @brief 后端通知用户越过空闲阈值或恢复活跃时发出
+     */
+    void idleStateChanged(bool idle);
+
+    /**
+     * @brief 活跃窗口进入或退出全屏时发出
+     */
+    void fullscreenChanged(bool fullscreen);
+
+    /**
+     * @brief 屏幕锁定或解锁时发出；锁定期间暂停采样
+     */
+    void screenLockChanged(bool locked);
+
+private:
+    void captureSample();
+    void publish(const Sample& sample);
+    void adjustSamplingRate(int idleMs);
+    void restoreFullSamplingRate();
+    void onSourceIdleStateChanged(bool idle);
+    void onSourceFullscreenChanged(bool fullscreen);
+    void onSourceScreenLockChanged(bool locked);
+    void suspendSampling();
+    void resumeSampling();
+    void countSuspendedWakeups();
+    void initializeInputSource();
+    quint32 getCurrentWindowTitleId();
+    quint32 getCurrentApplicationId();
+
+    SampleRing* m_ring;
+    QString m_displayName;
+    QTimer* m_timer;
+    bool m_running;
+    bool m_idleSuspended;
+    qint64 m_suspendedAtMs; // 暂停采样时的单调时间（毫秒）
+    int m_idleThresholdMs;
+
+    std::atomic<bool> m_notifyPending{false};
+    std::atomic<quint64> m_overruns{0};
+    std::atomic<quint64> m_samplesCaptured{0};
+    std::atomic<int> m_maxQueueDepth{0};
+    std::atomic<int> m_samplingIntervalMs{1000};
+    std::atomic<quint64> m_wakeupsSaved{0};
+    std::atomic<bool> m_idleNotifications{false};
+    std::atomic<bool> m_fullscreen{false};
+    std::atomic<bool> m_screenLocked{false};
+
+    // 输入后端等私有数据
+    class Private;
+    std::unique_ptr<Private> d;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QList>
+#include <QtGlobal>
+#include "ActivityMonitor.h"
+
+/**
+ * @brief 逐秒活动记录的列式内存存储
+ *
+ * 记录按块存放，每块最多 ChunkSize 条，块内每个字段一段连续数组：
+ * 时间为块起点（Unix 秒）加 16 位秒偏移，活跃状态按位打包，点击与按键为相对上一条记录的 16 位增量（超出截断），
+ * 窗口标题和应用程序 ID 按连续相同的区段保存。每条记录约 6 字节，按列求和时只访问用到的数组。
+ * 指针与滚轮数据不保存，按分钟的聚合见 ActivityBucket。
+ */
+class ActivityColumns
+{
+public:
+    static constexpr int ChunkSize = 4096;
+
+    struct Sample {
+        qint64 timestampSecs = 0;  // Unix 秒
+        bool isActive = false;
+        quint16 mouseClicks = 0;   // 自上一条记录以来的点击次数
+        quint16 keystrokes = 0;    // 自上一条记录以来的按键次数
+        quint32 windowTitleId = 0;
+        quint32 applicationId = 0;
+    };
+
+    void append(const ActivityMonitor::ActivityData& data);
+    void clear();
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 第 index 条记录，按追加顺序
+     */
+    Sample at(int index) const;
+
+    /**
+     * @brief 活跃记录数（即活跃秒数）
+     */
+    int activeCount() const;
+    qint64 totalMouseClicks() const;
+    qint64 totalKeystrokes() const;
+
+    /**
+     * @brief 各列实际占用的字节数
+     */
+    qint64 memoryUsage() const;
+
+private:
+    struct IdRun {
+        int first;                 // 区段第一条记录在块内的序号
+        quint32 windowTitleId;
+        quint32 applicationId;
+    };
+
+    struct Chunk {
+        qint64 baseSecs = 0;
+        QList<quint16> secondOffsets;
+        QList<quint64> activeBits;
+        QList<quint16> mouseClicks;
+        QList<quint16> keystrokes;
+        QList<IdRun> idRuns;
+
+        int size() const { return secondOffsets.size(); }
+    };
+
+    Chunk& chunkFor(qint64 timestampSecs);
+
+    QList<Chunk> m_chunks;
+    int m_size = 0;
+    int m_lastMouseClicks = -1;    // 上一条记录的累计点击数，-1 表示还没有记录
+    int m_lastKeystrokes = -1;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDate>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include "ActivityMonitor.h"
+#include "HealthEngine.h"
+#include "JournalFormat.h"
+
+class StorageWriter;
+
+/**
+ * @brief 按日分段、只追加的二进制活动日志
+ *
+ * 每个本地日期一个段文件，记录在产生时编码为定长记录并按日期缓存在内存中。
+ * commit() 把上次提交以来的新记录追加到对应段的末尾并刷到磁盘（组提交），开销与新增记录数成正比；
+ * 段文件即预写日志。清单（manifest）是每天汇总统计的快照，由 flush() 原子替换：
+ * 打开时只重放段中比快照多出的尾部。按日期查询只读取当天的段，按周统计只读清单。
+ * 旧数据按层级逐日压缩：compactSegment() 在后台线程把段重写为分钟层或小时层，
+ * applyCompaction() 在本线程原子替换段文件，段不会被整体删除。格式见 JournalFormat。
+ * 非线程安全，须在所属 DataAnalyzer 的线程中使用。
+ */
+class ActivityJournal
+{
+public:
+    struct HealthEvent {
+        qint64 timestampMs = 0;    // Unix 毫秒
+        HealthEngine::ReminderType type = HealthEngine::ReminderType::SittingTooLong;
+        QString action;
+    };
+
+    struct Contents {
+        QList<ActivityMonitor::ActivityData> activities;
+        QList<ActivityMonitor::ActivityBucket> buckets;
+        QList<ActivityMonitor::FocusInterval> focusIntervals;
+        QList<ActivityMonitor::BreakInterval> breaks;
+        QList<HealthEvent> healthEvents;
+    };
+
+    /**
+     * @brief 段的数据层级，越往后越粗
+     */
+    enum class Tier {
+        Raw,     // 全部记录
+        Minute,  // 去掉逐秒记录，没有分钟桶的分钟由逐秒记录补出
+        Hourly   // 分钟桶合并为小时桶，去掉焦点区间；读出时小时桶作为起点为整点的 ActivityBucket
+    };
+
+    struct DaySummary {
+        Tier tier = Tier::Raw;        // 段的层级
+        qint64 bytes = 0;             // 段文件字节数（含已提交但可能尚未落盘的追加）
+        int records = 0;              // 记录数
+        int buckets = 0;              // 分钟桶数
+        int activeSeconds = 0;        // 分钟桶的活跃秒数之和
+        int activeSamples = 0;        // 活跃的逐秒记录数（没有分钟桶的旧数据用它统计）
+        int mouseClicks = 0;          // 分钟桶的鼠标点击次数之和
+        int keystrokes = 0;           // 分钟桶的键盘输入次数之和
+        int breaks = 0;               // 休息次数
+        qint64 longestSittingMs = 0;  // 最长连续坐立时长（毫秒）
+        int healthEvents = 0;         // 健康事件数
+    };
+
+    /**
+     * @param directory 日志目录，不存在时在首次保存时创建
+     */
+    explicit ActivityJournal(const QString& directory);
+
+    /**
+     * @brief 数据文件（如 activity_log.json）对应的日志目录（activity_log.journal/）
+     */
+    static QString pathForDataFile(const QString& dataFilePath);
+
+    /**
+     * @brief 删除日志目录中的段文件、字典和清单；目录随之为空时一并删除
+     */
+    static void remove(const QString& directory);
+
+    /**
+     * @brief 用一组记录创建日志（迁移旧数据用）：先写入同级的临时目录，全部落盘后再改名为 directory
+     *
+     * directory 中已有段文件时不做任何修改并返回 false；中途失败时 directory 保持原样
+     */
+    static bool create(const QString& directory, const Contents& contents);
+
+    /**
+     * @brief 目录中是否已有段文件
+     */
+    static bool hasSegments(const QString& directory);
+
+    /**
+     * @brief 记录所属的日期：逐秒记录与健康事件按时间戳，分钟桶按分钟起点，区间按开始时间
+     */
+    static QDate dayOf(qint64 timestampMs);
+
+    QString directory() const { return m_directory; }
+    bool exists() const;
+
+    /**
+     * @brief 加载字典与清单，并按段文件恢复清单之后提交的记录；须在首次追加前调用
+     *
+     * 目录位置上是旧版单文件日志且目录中还没有段文件时，先按日期拆分导入（见 create()）
+     */
+    bool open();
+
+    /**
+     * @brief 设置共享的异步写入器；未设置时在调用线程同步写盘。写入器须比本对象存活更久
+     */
+    void setStorageWriter(StorageWriter* writer) { m_storageWriter = writer; }
+
+    /**
+     * @brief 有数据的日期，升序
+     */
+    QList<QDate> days() const { return m_manifest.keys(); }
+    bool hasDay(const QDate& date) const { return m_manifest.contains(date); }
+    DaySummary summary(const QDate& date) const { return m_manifest.value(date); }
+
+    /**
+     * @brief 读取一天的全部记录（含尚未保存的记录），只读取当天的段文件
+     */
+    bool loadDay(const QDate& date, Contents* contents);
+
+    void append(const ActivityMonitor::ActivityData& data);
+    void append(const ActivityMonitor::ActivityBucket& bucket);
+    void append(const ActivityMonitor::FocusInterval& interval);
+    void append(const ActivityMonitor::BreakInterval& interval);
+    void append(const HealthEvent& event);
+
+    bool hasPendingData() const;
+
+    /**
+     * @brief 把上次提交以来的新记录追加到各段并刷到磁盘，不写清单；失败时记录保留到下次提交
+     *
+     * 设置了写入器时只把追加交给写入器，记录保留到写入器确认落盘；之后的提交取回结果，
+     * 失败的追加截回原长度后重新提交。有记录等待确认时 hasPendingData() 仍为 true
+     */
+    bool commit();
+
+    /**
+     * @brief 提交新记录并等待落盘，在汇总变化时原子替换清单快照
+     */
+    void flush();
+
+    /**
+     * @brief 由记录计算一天的汇总
+     */
+    static DaySummary summarize(const Contents& contents);
+
+    struct Compaction {
+        qint64 sourceSize = -1;       // 读取时段文件的大小，失败时为 -1
+        QByteArray data;              // 新的段文件内容
+        DaySummary summary;
+    };
+
+    QString segmentPath(const QDate& date) const;
+
+    /**
+     * @brief 单遍扫描段文件，生成目标层级的新内容；只读文件，可在任意线程调用
+     */
+    static Compaction compactSegment(const QString& path, Tier target);
+
+    /**
+     * @brief 用压缩结果原子替换当天的段；段在压缩期间有新的追加时放弃，返回 false
+     */
+    bool applyCompaction(const QDate& date, const Compaction& compaction);
+
+private:
+    // 文件内 ID 与字符串的双向映射，文件内 ID 在各种类之间共用一个序列。
+    // 字典只属于本日志，字符串在读出引用它的记录时才驻留到进程级的池中
+    struct Dictionary {
+        QHash<quint32, QString> titles;             // 文件内 ID -> 字符串
+        QHash<quint32, QString> applications;
+        QHash<quint32, QString> actions;
+        QHash<QString, quint32> titleFileIds;       // 字符串 -> 文件内 ID
+        QHash<QString, quint32> applicationFileIds;
+        QHash<QString, quint32> actionFileIds;
+        QHash<quint32, quint32> titlePoolIds;       // 写入过的驻留池 ID -> 文件内 ID（池 ID 不复用）
+        QHash<quint32, quint32> applicationPoolIds;
+        quint32 nextFileId = 1;
+    };
+
+    static bool readDictionary(const QString& path, Dictionary* dictionary);
+    static qint64 readSegment(const QString& path, const Dictionary& dictionary, Contents* contents,
+                              qint64 fromBytes = 0);
+    static void parseRecords(const char* data, qint64 count, const Dictionary& dictionary, Contents* contents);
+
+    static bool readLegacyFile(const QString& filePath, const QString& dictionaryPath, Contents* contents);
+    bool importLegacyFile(const QString& filePath);
+    void appendContents(const Contents& contents);
+    char* beginRecord(const QDate& date, JournalFormat::RecordType type);
+    void finishRecord(char* payload);
+    quint32 dictionaryId(JournalFormat::DictionaryKind kind, quint32 poolId);
+    quint32 actionId(const QString& action);
+    void appendDictionaryEntry(JournalFormat::DictionaryKind kind, quint32 fileId, const QString& value);
+    bool collectAppends();
+    bool truncateTail(const QString& path, qint64 size);
+    void recoverDay(const QDate& date, qint64 segmentSize);
+    void loadManifest();
+    void saveManifest();
+
+    QString m_directory;
+    QString m_dictionaryPath;
+    QString m_manifestPath;
+    StorageWriter* m_storageWriter;
+    Dictionary m_dictionary;
+    qint64 m_dictionaryBytes;                 // 字典文件已落盘的长度
+    bool m_manifestDirty;
+    QByteArray m_pendingDictionary;
+    QMap<QDate, QByteArray> m_pendingRecords; // 日期 -> 尚未保存的记录
+    QMap<QDate, DaySummary> m_manifest;       // 日期 -> 段的汇总，与记录同步更新
+    QSet<QString> m_tornFiles;                // 追加失败、尾部可能留有部分数据的文件
+
+    // 已交给写入器、尚未确认落盘的追加；同一天同时只有一个
+    struct InFlightAppend {
+        QFuture<bool> result;
+        qsizetype records = 0;                // 本次追加取走的待提交记录字节数
+        qint64 bytes = 0;                     // 写入段文件的字节数（含段头）
+    };
+    QMap<QDate, InFlightAppend> m_inFlight;
+    QFuture<bool> m_manifestWrite;            // 最近一次交给写入器的清单快照
+};
@@ -1,15 +1,25 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
 #include <QTimer>
 #include <QDateTime>
 #include <memory>
+#include "ActivityCapture.h"
+
+class QThread;
+class TraceRecorder;
 
 /**
  * @brief 用户活动监测模块
  * 
  * 负责监测用户的键盘、鼠标活动以及屏幕使用时间
  * 提供活动数据给健康引擎进行分析
+ * 
+ * 平台采集运行在独立线程（ActivityCapture），采样经无锁队列批量交给 GUI 线程处理。
+ * 逐秒采样默认折叠为每分钟一个 ActivityBucket 再向下游发出，焦点变化时另发出一个 FocusInterval；
+ * 逐秒的 activityDetected 仅在高精度模式下发出；需要逐秒数据的消费者应连接 activityBatchReady，
+ * 按批接收以摊薄信号调用与数据复制的开销。
  */
 class ActivityMonitor : public QObject
 {
@@ -21,7 +31,66 @@ public:
         int mouseClicks;      // 鼠标点击次数
         int keystrokes;       // 键盘输入次数
         bool isActive;        // 是否活跃状态
-        QString activeWindow; // 当前活跃窗口
+        quint32 windowTitleId; // 当前活跃窗口标题 ID
+        quint32 applicationId = 0; // 当前活跃应用程序 ID，按应用统计时直接按 ID 分组
+        double pointerDistance = 0.0; // 自上一采样以来的指针移动距离（像素）
+        double pointerVelocity = 0.0; // 自上一采样以来的平均指针速度（像素/秒）
+        int wheelTicks = 0;   // 自上一采样以来的滚轮格数
+
+        /**
+         * @brief 解析当前活跃窗口标题，仅在显示或导出时调用
+         */
+        QString activeWindowTitle() const;
+
+        /**
+         * @brief 解析当前活跃应用程序名，仅在显示或导出时调用
+         */
+        QString activeApplicationName() const;
+    };
+
+    /**
+     * @brief 一批逐秒活动数据；隐式共享，发出后只读，接收方保存时只增加引用计数
+     */
+    using ActivityBatch = QList<ActivityData>;
+
+    struct ActivityBucket {
+        qint64 minuteStartMs = 0;          // 分钟起始时间（Unix 毫秒）
+        int activeSeconds = 0;             // 本分钟活跃秒数（0-60）
+        int mouseClicks = 0;               // 本分钟鼠标点击次数
+        int keystrokes = 0;                // 本分钟键盘输入次数
+        quint32 dominantWindowTitleId = 0; // 停留最久的窗口标题 ID
+        double pointerDistance = 0.0;      // 本分钟指针移动距离（像素）
+        double peakVelocity = 0.0;         // 本分钟采样粒度的峰值指针速度（像素/秒）
+        double meanVelocity = 0.0;         // 指针移动期间的平均速度（像素/秒）
+        int wheelTicks = 0;                // 本分钟滚轮格数
+        quint32 dominantApplicationId = 0; // 停留最久的应用程序 ID
+        LogHistogram keyIntervals;         // 本分钟按键间隔分布，逐桶相加即可合并到日/周
+    };
+
+    struct FocusInterval {
+        qint64 startMs = 0;                // 获得焦点的时间（Unix 毫秒）
+        qint64 endMs = 0;                  // 失去焦点的时间（Unix 毫秒）
+        quint32 applicationId = 0;         // 应用程序 ID
+        quint32 windowTitleId = 0;         // 窗口标题 ID
+        int activeSeconds = 0;             // 区间内的活跃秒数
+        int mouseClicks = 0;               // 区间内的鼠标点击次数
+        int keystrokes = 0;                // 区间内的键盘输入次数
+    };
+
+    struct BreakInterval {
+        qint64 startMs = 0;                // 离开开始（最后一次输入，Unix 毫秒）
+        qint64 endMs = 0;                  // 回到座位（Unix 毫秒）
+        qint64 sittingMs = 0;              // 本次休息前的连续坐立时长（毫秒）
+    };
+
+    struct CaptureStats {
+        quint64 samplesCaptured = 0; // 已入队采样数
+        quint64 overruns = 0;        // 队列满而丢弃的采样数
+        int queueDepth = 0;          // 当前队列深度
+        int maxQueueDepth = 0;       // 历史最大队列深度
+        int queueCapacity = 0;       // 队列容量
+        int samplingIntervalMs = 0;  // 当前采样间隔
+        quint64 wakeupsSaved = 0;    // 空闲退避与暂停采样节省的唤醒次数
     };
 
     explicit ActivityMonitor(QObject *parent = nullptr);
@@ -48,16 +117,94 @@ public:
     QDateTime getLastActivityTime() const;
 
     /**
-     * @brief 获取今日总活动时间（分钟）
+     * @brief 获取今日总活动时间（分钟），按已发出的分钟桶的活跃秒数累计，跨过午夜后从零开始
      */
     int getTodayActiveMinutes() const;
 
+    /**
+     * @brief 获取采集统计，用于观察队列背压与采样频率
+     */
+    CaptureStats getCaptureStats() const;
+
+    /**
+     * @brief 高精度模式：除分钟桶外，逐秒发出 activityDetected（默认关闭）
+     */
+    void setHighResolutionMode(bool enabled);
+    bool isHighResolutionMode() const { return m_highResolution; }
+
+    /**
+     * @brief 立即发出尚未完成的批次、分钟桶和焦点区间（停止监测或回放结束时调用）
+     */
+    void flushAggregation();
+
+    /**
+     * @brief 指定监测的 X 显示（如 ":12"），为空时使用 $DISPLAY；须在 start() 之前调用
+     */
+    void setDisplayName(const QString& displayName);
+    QString displayName() const { return m_displayName; }
+
+    /**
+     * @brief 设置判定用户空闲的无输入时长（毫秒，默认 30 秒）
+     * 
+     * X11 下由 XSync 空闲报警在越过阈值时通知；其他后端按采样判断
+     */
+    void setIdleThreshold(int thresholdMs);
+    int idleThreshold() const { return m_idleThresholdMs; }
+
+    /**
+     * @brief 设置休息判定：离开不少于 minBreakMs 计为一次休息，
+     *        间隔短于 mergeGapMs 的两段离开合并为一次（默认 5 分钟 / 1 分钟）
+     */
+    void setBreakThresholds(qint64 minBreakMs, qint64 mergeGapMs);
+
+    /**
+     * @brief 活跃窗口是否全屏（演示、视频等），读取缓存值
+     */
+    bool isFullscreenActive() const;
+
+    /**
+     * @brief 屏幕是否已锁定（或屏保已启动），读取缓存值
+     */
+    bool isScreenLocked() const;
+
+    /**
+     * @brief 设置轨迹录制器，之后处理的每个采样都会被录制；传入 nullptr 停止录制
+     */
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    /**
+     * @brief 直接注入一个采样（轨迹回放使用），与实时采样走相同的处理流程
+     */
+    void injectSample(const ActivityCapture::Sample& sample);
+
 signals:
     /**
-     * @brief 检测到用户活动时发出
+     * @brief 检测到用户活动时发出（仅高精度模式）
      */
     void activityDetected(const ActivityData& data);
 
+    /**
+     * @brief 逐秒活动数据的批量版本（仅高精度模式），满 64 条或最早一条超过 5 秒时发出
+     * 
+     * 只有连接了该信号时才会组批
+     */
+    void activityBatchReady(const ActivityMonitor::ActivityBatch& batch);
+
+    /**
+     * @brief 每完成一分钟的聚合发出一次
+     */
+    void activityBucketReady(const ActivityBucket& bucket);
+
+    /**
+     * @brief 活跃窗口（应用程序或标题）变化时发出上一个焦点区间
+     */
+    void focusIntervalReady(const FocusInterval& interval);
+
+    /**
+     * @brief 确认一次休息时发出（休息结束后再等待一个合并间隔）
+     */
+    void breakDetected(const BreakInterval& interval);
+
     /**
      * @brief 用户变为非活跃状态时发出
      */
@@ -68,23 +215,42 @@ signals:
      */
     void userBecameActive();
 
+    /**
+     * @brief 活跃窗口进入或退出全屏时发出
+     */
+    void fullscreenChanged(bool fullscreen);
+
+    /**
+     * @brief 屏幕锁定或解锁时发出；锁定即视为离开，锁定期间不再产生采样
+     */
+    void screenLockChanged(bool locked);
+
 private slots:
-    void checkActivity();
+    void drainSamples();
+    void onIdleStateChanged(bool idle);
+    void onScreenLockChanged(bool locked);
+    void flushBatch();
 
 private:
-    void initializeSystemHooks();
-    void cleanupSystemHooks();
-    int getCurrentMouseClicks();
-    int getCurrentKeystrokes();
-    QString getCurrentActiveWindow();
-
-    QTimer* m_timer;
-    QDateTime m_lastActivityTime;
+    void processSample(const ActivityCapture::Sample& sample);
+    void setUserActive(bool active, qint64 timestampMs);
+    void appendToBatch(const ActivityData& data);
+    void emitBucket(const ActivityBucket& bucket);
+
+    QThread* m_captureThread;
+    QTimer* m_batchTimer;
+    ActivityCapture* m_capture;
+    TraceRecorder* m_traceRecorder;
+    QString m_displayName;
+    bool m_highResolution;
+    int m_idleThresholdMs;
+    qint64 m_lastActivityMs; // 最近一次活动的 Unix 毫秒，只在接口处转换为 QDateTime
     QDateTime m_sessionStartTime;
     bool m_isActive;
-    int m_todayActiveMinutes;
+    QDate m_todayDate;        // 今日活跃时间所属的日期
+    int m_todayActiveSeconds;
     
-    // 平台相关的私有数据
+    // GUI 线程侧的私有数据（采样队列与上次计数）
     class Private;
     std::unique_ptr<Private> d;
 };
\ No newline at end of file
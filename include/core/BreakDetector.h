@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ActivityMonitor.h"
+
+/**
+ * @brief 流式休息检测器
+ * 
+ * 将活跃/空闲状态切换折叠为休息区间：离开时长不少于最短休息时长才计为一次休息，
+ * 两段离开之间的短暂活动（如路过时碰到鼠标）短于合并间隔时合并为同一次休息。
+ * 休息结束后还需等待一个合并间隔才能确认，确认后输出休息区间及其之前的连续坐立时长。
+ * 每次状态切换和采样都是 O(1)，不做动态分配。
+ */
+class BreakDetector
+{
+public:
+    BreakDetector();
+
+    /**
+     * @brief 设置最短休息时长与合并间隔（毫秒）
+     */
+    void setThresholds(qint64 minBreakMs, qint64 mergeGapMs);
+
+    /**
+     * @brief 用户变为空闲，lastInputMs 为最后一次输入的时间（Unix 毫秒）
+     */
+    bool userBecameIdle(qint64 lastInputMs, ActivityMonitor::BreakInterval* completed);
+
+    /**
+     * @brief 用户恢复活跃
+     */
+    void userBecameActive(qint64 timestampMs);
+
+    /**
+     * @brief 每个采样调用：确认已超过合并间隔的休息；活跃期间采样中断（如系统挂起）也视为离开
+     */
+    bool update(qint64 timestampMs, ActivityMonitor::BreakInterval* completed);
+
+    /**
+     * @brief 立即确认尚在合并间隔内的休息（停止监测时调用）
+     */
+    bool flush(ActivityMonitor::BreakInterval* completed);
+
+private:
+    bool finishPending(ActivityMonitor::BreakInterval* completed);
+
+    qint64 m_minBreakMs;
+    qint64 m_mergeGapMs;
+    bool m_idle;
+    bool m_hasPending;        // 已结束、但仍可能与下一段离开合并的离开
+    qint64 m_sessionStartMs;  // 当前连续坐立时段的开始（上次休息结束），0 表示尚未开始
+    qint64 m_idleStartMs;     // 当前（合并后的）离开开始
+    qint64 m_idleEndMs;       // 待确认离开的结束
+    qint64 m_lastUpdateMs;
+};
@@ -24,6 +24,7 @@ public:
         bool soundEnabled = true;        // 声音提醒
         bool showNotifications = true;   // 显示通知
         int notificationDuration = 5;    // 通知持续时间（秒）
+        bool suppressInFullscreen = true; // 全屏/演示时暂停提醒
     };
 
     struct WorkSchedule {
@@ -37,8 +38,14 @@ public:
         bool collectAnonymousStats = false;  // 收集匿名统计
         bool enableLogging = true;           // 启用日志
         QString logLevel = "INFO";           // 日志级别
-        int dataRetentionDays = 30;          // 数据保留天数
+        int dataRetentionDays = 30;          // 分钟数据保留天数，之后合并为永久保留的小时汇总
+        int rawRetentionDays = 7;            // 逐秒记录保留天数，之后只保留分钟数据
         bool enableSmartAdaptation = true;   // 智能适应
+        bool highResolutionCapture = false;  // 高精度模式：额外保存逐秒活动记录
+        int idleThresholdSeconds = 30;       // 无输入多久判定为空闲（秒）
+        int minBreakSeconds = 300;           // 离开多久计为一次休息（秒）
+        int breakMergeGapSeconds = 60;       // 两段离开之间的活动短于该值时合并为一次休息（秒）
+        int journalCommitSeconds = 5;        // 活动日志组提交间隔（秒），异常退出最多丢失这段时间的数据
     };
 
     explicit ConfigManager(QObject *parent = nullptr);
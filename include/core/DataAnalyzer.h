@@ -4,8 +4,15 @@
 #include <QJsonObject>
 #include <QDateTime>
 #include <QList>
+#include <QMap>
+#include <QThreadPool>
 #include "HealthEngine.h"
 #include "ActivityMonitor.h"
+#include "ActivityColumns.h"
+#include "ActivityJournal.h"
+#include <memory>
+
+class StorageWriter;
 
 /**
  * @brief 数据分析模块
@@ -23,6 +30,8 @@ public:
         int totalBreaks;            // 总休息次数
         int longestSittingSession;  // 最长连续坐立时间
         double healthScore;         // 健康评分
+        double keyIntervalP50Ms;    // 按键间隔中位数（毫秒，越小打字越快）
+        double keyIntervalP95Ms;    // 按键间隔 95 分位（毫秒）
         QList<QPair<QTime, QString>> events; // 事件时间线
     };
 
@@ -34,6 +43,29 @@ public:
         QList<double> dailyScores; // 每日评分
     };
 
+    struct HourlyMouseLoad {
+        int hour;                  // 小时（0-23）
+        double pointerDistance;    // 指针移动距离（像素）
+        double peakVelocity;       // 峰值指针速度（像素/秒）
+        int mouseClicks;           // 鼠标点击次数
+        int wheelTicks;            // 滚轮格数
+    };
+
+    struct ApplicationUsage {
+        quint32 applicationId;     // 应用程序 ID（StringInternPool::applications()）
+        QString applicationName;   // 应用程序名
+        int activeSeconds;         // 获得焦点期间的活跃秒数
+        int focusedSeconds;        // 获得焦点的总秒数
+        int focusCount;            // 获得焦点的次数
+    };
+
+    struct FocusSummary {
+        int intervalCount;         // 焦点区间数（窗口切换次数 + 1）
+        int applicationSwitches;   // 应用程序之间的切换次数
+        double switchesPerHour;    // 每活跃小时的应用程序切换次数
+        int longestFocusSeconds;   // 在同一应用程序内连续停留的最长时间（秒）
+    };
+
     struct HealthInsight {
         QString title;             // 洞察标题
         QString description;       // 详细描述
@@ -42,24 +74,95 @@ public:
         QString category;         // 分类
     };
 
-    explicit DataAnalyzer(QObject *parent = nullptr);
+    /**
+     * @param dataFilePath 数据文件路径，为空时使用应用数据目录下的默认文件；
+     *        数据按日分段保存在同目录同名的 .journal 日志目录中，旧版 JSON 文件在首次加载时迁移
+     */
+    explicit DataAnalyzer(const QString& dataFilePath = QString(), QObject *parent = nullptr);
     ~DataAnalyzer();
 
     /**
-     * @brief 记录用户活动数据
+     * @brief 设置共享的异步写入器；未设置时在调用线程同步写盘。写入器须比本对象存活更久
+     */
+    void setStorageWriter(StorageWriter* writer);
+
+    /**
+     * @brief 设置日志组提交间隔：新记录最迟在该时间后追加到日志并刷到磁盘
+     */
+    void setCommitInterval(int intervalMs);
+
+    /**
+     * @brief 设置各层级的保留天数并在后台压缩过期的数据，之后每天检查一次
+     * @param rawDays 逐秒记录保留天数
+     * @param retentionDays 分钟数据保留天数，更早的日子只保留小时汇总
+     */
+    void setRetention(int rawDays, int retentionDays);
+
+    /**
+     * @brief 记录逐秒活动数据（高精度模式）
      */
     void recordActivity(const ActivityMonitor::ActivityData& data);
 
+    /**
+     * @brief 批量记录逐秒活动数据，整批只发出一次 dataUpdated
+     */
+    void recordActivityBatch(const ActivityMonitor::ActivityBatch& batch);
+
+    /**
+     * @brief 记录每分钟的活动聚合
+     */
+    void recordActivityBucket(const ActivityMonitor::ActivityBucket& bucket);
+
+    /**
+     * @brief 记录焦点区间
+     */
+    void recordFocusInterval(const ActivityMonitor::FocusInterval& interval);
+
+    /**
+     * @brief 记录检测到的休息
+     */
+    void recordBreak(const ActivityMonitor::BreakInterval& interval);
+
     /**
      * @brief 记录健康事件
      */
     void recordHealthEvent(HealthEngine::ReminderType type, const QString& action);
 
+    /**
+     * @brief 屏幕锁定时立即保存并停止定期分析，解锁后恢复
+     */
+    void onScreenLockChanged(bool locked);
+
     /**
      * @brief 获取指定日期的报告
      */
     DailyReport getDailyReport(const QDate& date = QDate::currentDate()) const;
 
+    /**
+     * @brief 获取指定日期每小时的鼠标负荷（24 项，按小时排列）
+     */
+    QList<HourlyMouseLoad> getHourlyMouseLoad(const QDate& date = QDate::currentDate()) const;
+
+    /**
+     * @brief 合并日期范围内（含两端）各分钟的按键间隔分布
+     */
+    LogHistogram getKeyIntervalHistogram(const QDate& startDate, const QDate& endDate) const;
+
+    /**
+     * @brief 获取指定日期开始的焦点区间
+     */
+    QList<ActivityMonitor::FocusInterval> getFocusIntervals(const QDate& date = QDate::currentDate()) const;
+
+    /**
+     * @brief 获取指定日期按应用程序汇总的使用时间（由焦点区间统计），按活跃秒数降序排列
+     */
+    QList<ApplicationUsage> getApplicationUsage(const QDate& date = QDate::currentDate()) const;
+
+    /**
+     * @brief 获取指定日期的上下文切换统计
+     */
+    FocusSummary getFocusSummary(const QDate& date = QDate::currentDate()) const;
+
     /**
      * @brief 获取周趋势分析
      */
@@ -81,7 +184,8 @@ public:
     bool importData(const QJsonObject& data);
 
     /**
-     * @brief 清理旧数据
+     * @brief 在后台压缩旧数据：逐秒记录超过逐秒保留天数的日子只保留分钟数据，
+     *        超过 retentionDays 天的日子合并为小时汇总（永久保留）。报表照常读取各层级
      */
     void cleanupOldData(int retentionDays);
 
@@ -107,23 +211,55 @@ private:
     double calculateDailyHealthScore(const QDate& date) const;
     void saveDataToFile();
     void loadDataFromFile();
+    bool migrateLegacyDataFile(const QString& path);
+    void commitJournal();
+    void startNextCompaction();
+    void finishCompaction(const QDate& date, const ActivityJournal::Compaction& compaction);
+    template <typename Record>
+    void appendToJournal(const Record& record);
     QString getDataFilePath() const;
 
-    struct ActivityRecord {
-        QDateTime timestamp;
-        ActivityMonitor::ActivityData data;
-    };
+    using HealthEventRecord = ActivityJournal::HealthEvent;
 
-    struct HealthEventRecord {
-        QDateTime timestamp;
-        HealthEngine::ReminderType type;
-        QString action;
+    struct DayData {
+        ActivityColumns activities;  // 逐秒记录，列式存储
+        QList<ActivityMonitor::ActivityBucket> buckets;
+        QList<ActivityMonitor::FocusInterval> focusIntervals;
+        QList<ActivityMonitor::BreakInterval> breaks;
+        QList<HealthEventRecord> healthEvents;
     };
 
-    QList<ActivityRecord> m_activityRecords;
-    QList<HealthEventRecord> m_healthEvents;
+    /**
+     * @brief 一天的全部记录，首次访问时从当天的段读取并缓存
+     */
+    const DayData& dayData(const QDate& date) const;
+
+    /**
+     * @brief 已缓存的一天；未缓存时返回空（记录只写入日志），没有日志时创建
+     */
+    DayData* cachedDay(const QDate& date);
+    bool hasDay(const QDate& date) const;
+    ActivityJournal::DaySummary daySummary(const QDate& date) const;
+    static ActivityJournal::DaySummary summarize(const DayData& day);
+
+    mutable QMap<QDate, DayData> m_days;   // 日期 -> 已加载的记录；没有日志时保存全部数据
+    mutable QList<QDate> m_recentDays;     // 最近查询的日期，最久未用的在前
     QList<HealthInsight> m_insights;
     
     QDateTime m_lastAnalysisTime;
     QTimer* m_analysisTimer;
+    QTimer* m_commitTimer;
+
+    struct CompactionTask {
+        QDate date;
+        ActivityJournal::Tier target;
+    };
+    int m_rawRetentionDays;
+    int m_retentionDays;
+    QDate m_lastCleanupDate;
+    QList<CompactionTask> m_compactionQueue;
+    bool m_compacting;
+    QThreadPool m_compactionPool;            // 单线程，压缩时只读取段文件
+    QString m_dataFilePath;
+    std::unique_ptr<ActivityJournal> m_journal; // 没有可写的数据目录时为空
 };
\ No newline at end of file
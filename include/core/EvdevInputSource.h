@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InputSource.h"
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief evdev 输入后端
+ * 
+ * 直接读取 /dev/input/event*（或任意提供 input_event 流的文件描述符），
+ * 适用于 Wayland 会话与无显示服务的终端。所有描述符注册到同一个 epoll 实例，
+ * 由 epoll 描述符上的 QSocketNotifier 唤醒，每次 read() 批量读取多条事件。
+ */
+class EvdevInputSource : public InputSource
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief devicePaths 为空时在 open() 中扫描 /dev/input/event*
+     */
+    explicit EvdevInputSource(const QStringList& devicePaths = QStringList(), QObject *parent = nullptr);
+    ~EvdevInputSource() override;
+
+    QString name() const override { return "evdev"; }
+    bool open() override;
+    void close() override;
+    bool isEventDriven() const override { return true; }
+    void poll() override;
+    Counters counters() const override { return m_counters; }
+    int idleMilliseconds() override;
+
+    /**
+     * @brief 加入一个已打开的描述符（例如回放录制事件的管道），所有权转移给本对象
+     * 
+     * 须在 open() 之后调用
+     */
+    bool addFileDescriptor(int fd);
+
+    /**
+     * @brief 当前监听的描述符数量
+     */
+    int deviceCount() const { return m_fds.size(); }
+
+private:
+    void readEvents();
+    bool drainDescriptor(int fd);
+    void removeDescriptor(int fd);
+
+    QStringList m_devicePaths;
+    QVector<int> m_fds;
+    int m_epollFd;
+    class QSocketNotifier* m_notifier;
+
+    Counters m_counters;
+    qint64 m_lastInputMs;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ActivityMonitor.h"
+
+/**
+ * @brief 焦点区间跟踪器
+ * 
+ * 将逐秒采样折叠为窗口焦点区间：活跃应用程序或窗口标题变化时结束上一个区间，
+ * 累计区间内的活跃秒数与输入次数。一天通常只有几百个区间，而不是 86400 个采样。
+ * 只保存当前区间的累加值，不做动态分配。
+ */
+class FocusTracker
+{
+public:
+    FocusTracker();
+
+    /**
+     * @brief 加入一个采样
+     * 
+     * 焦点发生变化时，上一个区间写入 completed 并返回 true
+     */
+    bool add(qint64 timestampMs, bool isActive, int clickDelta, int keyDelta,
+             quint32 windowTitleId, quint32 applicationId,
+             ActivityMonitor::FocusInterval* completed);
+
+    /**
+     * @brief 输出尚未结束的当前区间，没有数据时返回 false
+     */
+    bool flush(ActivityMonitor::FocusInterval* completed);
+
+private:
+    void finishInterval(ActivityMonitor::FocusInterval* completed);
+
+    bool m_hasInterval;
+    ActivityMonitor::FocusInterval m_current;
+    qint64 m_activeMilliseconds;
+    qint64 m_lastTimestampMs;
+};
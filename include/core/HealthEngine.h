@@ -78,6 +78,11 @@ public:
      */
     void pauseReminders(int minutes);
 
+    /**
+     * @brief 活跃窗口全屏（演示、视频、游戏）时是否暂不弹出提醒，默认开启
+     */
+    void setSuppressInFullscreen(bool suppress);
+
 signals:
     /**
      * @brief 需要显示提醒时发出
@@ -91,10 +96,41 @@ signals:
 
 public slots:
     /**
-     * @brief 接收用户活动数据
+     * @brief 接收逐秒活动数据（高精度模式），只用于更新当前活跃状态
      */
     void onActivityDetected(const ActivityMonitor::ActivityData& data);
 
+    /**
+     * @brief 批量接收逐秒活动数据（高精度模式），取最后一条更新当前活跃状态
+     */
+    void onActivityBatch(const ActivityMonitor::ActivityBatch& batch);
+
+    /**
+     * @brief 接收每分钟的活动聚合，累计坐立时间
+     */
+    void onActivityBucket(const ActivityMonitor::ActivityBucket& bucket);
+
+    /**
+     * @brief 用户空闲/恢复活跃时更新状态，空闲期间不会收到分钟桶
+     */
+    void onUserBecameInactive();
+    void onUserBecameActive();
+
+    /**
+     * @brief 活跃窗口进入或退出全屏
+     */
+    void onFullscreenChanged(bool fullscreen);
+
+    /**
+     * @brief 屏幕锁定时停止全部计时器，解锁后恢复
+     */
+    void onScreenLockChanged(bool locked);
+
+    /**
+     * @brief 检测到用户离开座位休息：重置坐立与眼部休息计时
+     */
+    void onBreakDetected(const ActivityMonitor::BreakInterval& interval);
+
 private slots:
     void checkSittingTime();
     void checkEyeRest();
@@ -103,13 +139,17 @@ private slots:
 
 private:
     void initializeDefaultConfigs();
+    void checkForResume();
+    bool remindersPaused() const;
     void logHealthEvent(ReminderType type, const QString& action);
     double calculateHealthScore() const;
 
+    // 计时均使用单调时钟毫秒（MonotonicClock），不受时区和系统时间调整影响，也不含挂起时间
     QDateTime m_sessionStartTime;
-    QDateTime m_lastSittingBreak;
-    QDateTime m_lastEyeBreak;
-    QDateTime m_lastNeckExercise;
+    qint64 m_lastSittingBreakMs;
+    qint64 m_lastEyeBreakMs;
+    qint64 m_lastNeckExerciseMs;
+    qint64 m_lastSuspendedNs;
     
     QTimer* m_sittingTimer;
     QTimer* m_eyeRestTimer;
@@ -117,7 +157,10 @@ private:
     QTimer* m_statsTimer;
     
     bool m_remindersPaused;
-    QDateTime m_pauseEndTime;
+    qint64 m_pauseEndMs;
+    bool m_fullscreenActive;
+    bool m_suppressInFullscreen;
+    bool m_suspendedForLock;    // 计时器因锁屏而停止，解锁时需重新启动
     
     QMap<ReminderType, ReminderConfig> m_configs;
     HealthStats m_todayStats;
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include "utils/LogHistogram.h"
+
+/**
+ * @brief 输入采集后端接口
+ * 
+ * 屏蔽不同平台/会话类型（X11、evdev、Windows 轮询等）的差异，
+ * 由 ActivityCapture 在采集线程中创建并使用。计数器均为累计值。
+ */
+class InputSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Counters {
+        int mouseClicks = 0;   // 累计鼠标点击次数
+        int keystrokes = 0;    // 累计键盘输入次数
+        int motionEvents = 0;  // 累计指针移动事件数
+        double pointerDistance = 0.0; // 累计指针移动距离（像素，仅相对移动设备）
+        int wheelTicks = 0;    // 累计滚轮格数
+        LogHistogram keyIntervals; // 累计按键间隔分布
+        qint64 lastKeystrokeMs = 0; // 上一次按键的事件时间（毫秒，各后端时间基准不同，只用于求差）
+
+        /**
+         * @brief 记录一次按键，并把与上一次按键的间隔计入分布
+         */
+        void addKeystroke(qint64 timestampMs)
+        {
+            keystrokes++;
+            if (lastKeystrokeMs > 0) {
+                keyIntervals.addInterval(timestampMs - lastKeystrokeMs);
+            }
+            lastKeystrokeMs = timestampMs;
+        }
+    };
+
+    explicit InputSource(QObject *parent = nullptr);
+    ~InputSource() override;
+
+    /**
+     * @brief 后端名称，如 "x11"、"evdev"
+     */
+    virtual QString name() const = 0;
+
+    /**
+     * @brief 打开后端，须在采集线程中调用；失败时返回 false
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief 关闭后端并释放资源
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 是否由输入事件驱动（否则依赖 poll() 轮询状态）
+     */
+    virtual bool isEventDriven() const = 0;
+
+    /**
+     * @brief 每次采样前调用：事件驱动后端处理已缓存事件，轮询后端读取当前状态
+     */
+    virtual void poll() {}
+
+    /**
+     * @brief 获取累计输入计数
+     */
+    virtual Counters counters() const = 0;
+
+    /**
+     * @brief 距上次输入的毫秒数，无法获取时返回 -1
+     */
+    virtual int idleMilliseconds() { return -1; }
+
+    /**
+     * @brief 当前活跃窗口标题，后端无窗口信息时返回空字符串
+     */
+    virtual QString activeWindowTitle() { return QString(); }
+
+    /**
+     * @brief 当前活跃窗口所属进程 ID，后端无窗口信息或无法获取时返回 0
+     */
+    virtual qint64 activeWindowPid() { return 0; }
+
+    /**
+     * @brief 活跃窗口是否全屏（缓存值，不产生系统调用）；状态变化时发出 fullscreenChanged
+     */
+    virtual bool isActiveWindowFullscreen() const { return false; }
+
+    /**
+     * @brief 屏幕是否已锁定或屏保已启动；状态变化时发出 screenLockChanged
+     */
+    virtual bool isScreenLocked() const { return false; }
+
+    /**
+     * @brief 设置空闲阈值，越过阈值时由后端发出 idleStateChanged
+     * 
+     * 后端无法主动通知空闲状态时返回 false，调用方需自行根据输入时间判断
+     */
+    virtual bool setIdleThreshold(int thresholdMs) { Q_UNUSED(thresholdMs); return false; }
+
+    /**
+     * @brief 按名称（"x11"、"evdev"、"polling"）创建后端，名称未知时返回 nullptr
+     * 
+     * displayName 指定 X 显示（如 ":12"），为空时使用 $DISPLAY；其他后端忽略该参数
+     */
+    static std::unique_ptr<InputSource> create(const QString& backend, const QString& displayName = QString());
+
+    /**
+     * @brief 依次尝试的后端名称
+     * 
+     * backend 为空时读取环境变量 WELLNESS_INPUT_BACKEND，仍为空则自动选择：
+     * Linux 下有 DISPLAY 时先 x11 后 evdev，否则只用 evdev；其他平台使用轮询后端
+     */
+    static QStringList candidateBackends(const QString& backend = QString());
+
+signals:
+    /**
+     * @brief 事件驱动后端收到输入事件时发出
+     */
+    void inputReceived();
+
+    /**
+     * @brief 用户空闲时长越过阈值（idle 为 true）或空闲后恢复输入（idle 为 false）时发出
+     */
+    void idleStateChanged(bool idle);
+
+    /**
+     * @brief 活跃窗口进入或退出全屏时发出
+     */
+    void fullscreenChanged(bool fullscreen);
+
+    /**
+     * @brief 屏幕锁定/屏保启动（locked 为 true）或解锁时发出
+     */
+    void screenLockChanged(bool locked);
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtEndian>
+#include <QtGlobal>
+#include <cstring>
+
+/**
+ * @brief 活动日志（journal）文件格式
+ *
+ * 日志是一个目录：每个本地日期一个段文件 (yyyy-MM-dd.seg)，所有段共用一个字典文件 (strings.dict)，
+ * manifest.json 记录每天的段文件、字节数与汇总统计，是定期原子替换的快照，可能落后于段文件。
+ *
+ * 段文件 (*.seg)：16 字节文件头 = 8 字节魔数 "WWEJOURN" + 1 字节版本号 + 1 字节保留
+ * + 2 字节记录长度 + 4 字节保留；随后是定长记录，每条 RecordSize 字节：
+ *   类型(1) + 保留(1) + 载荷校验和(2) + 保留(4) + 载荷(64)。
+ * 载荷字段均为小端，偏移见各 RecordType 注释；KeyIntervals 紧跟在它所属的 Bucket 之后。
+ *
+ * 字典文件：16 字节文件头 = 8 字节魔数 "WWEJDICT" + 1 字节版本号 + 7 字节保留；
+ * 随后是变长条目：种类(1) + 文件内 ID(4) + 长度(2) + UTF-8 字节。
+ * 记录中的标题、应用程序和健康事件动作只保存文件内 ID，加载时映射到进程内驻留池。
+ *
+ * 段文件与字典都只追加。异常退出留下的不完整尾部在下次加载时截掉，之后的追加仍按记录对齐。
+ * 过了保留期的段由压缩整体重写为更粗的层级：分钟层去掉逐秒记录，小时层把分钟桶合并为 HourBucket 并去掉焦点区间。
+ */
+namespace JournalFormat {
+
+constexpr char Magic[8] = {'W', 'W', 'E', 'J', 'O', 'U', 'R', 'N'};
+constexpr char DictionaryMagic[8] = {'W', 'W', 'E', 'J', 'D', 'I', 'C', 'T'};
+constexpr quint8 Version = 1;
+constexpr int HeaderSize = 16;
+constexpr int RecordHeaderSize = 8;
+constexpr int PayloadSize = 64;
+constexpr int RecordSize = RecordHeaderSize + PayloadSize;
+constexpr int DictionaryEntryHeaderSize = 7;
+constexpr int MaxDictionaryValueSize = 0xffff;
+
+enum RecordType : quint8 {
+    RecordActivity = 1,     // 时间戳 i64 @0, 点击 i32 @8, 按键 i32 @12, 标题 u32 @16, 应用 u32 @20,
+                            // 指针距离 f64 @24, 指针速度 f64 @32, 滚轮 i32 @40, 是否活跃 u8 @44
+    RecordBucket = 2,       // 分钟起点 i64 @0, 活跃秒数 i32 @8, 点击 i32 @12, 按键 i32 @16, 标题 u32 @20,
+                            // 应用 u32 @24, 滚轮 i32 @28, 距离 f64 @32, 峰值速度 f64 @40, 平均速度 f64 @48
+    RecordKeyIntervals = 3, // 32 个按键间隔桶计数 u16（超出部分截断为 65535），跟在 Bucket 或 HourBucket 之后
+    RecordFocus = 4,        // 开始 i64 @0, 结束 i64 @8, 应用 u32 @16, 标题 u32 @20,
+                            // 活跃秒数 i32 @24, 点击 i32 @28, 按键 i32 @32
+    RecordBreak = 5,        // 开始 i64 @0, 结束 i64 @8, 连续坐立 i64 @16
+    RecordHealthEvent = 6,  // 时间戳 i64 @0, 提醒类型 i32 @8, 动作 u32 @12
+    RecordHourBucket = 7    // 小时汇总，布局同 Bucket，起点为本地整点
+};
+
+enum DictionaryKind : quint8 {
+    DictionaryTitle = 1,
+    DictionaryApplication = 2,
+    DictionaryAction = 3
+};
+
+template <typename T>
+inline void writeValue(char* dst, T value)
+{
+    qToLittleEndian<T>(value, dst);
+}
+
+template <typename T>
+inline T readValue(const char* src)
+{
+    return qFromLittleEndian<T>(src);
+}
+
+inline void writeDouble(char* dst, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeValue<quint64>(dst, bits);
+}
+
+inline double readDouble(const char* src)
+{
+    const quint64 bits = readValue<quint64>(src);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline QByteArray recordFileHeader()
+{
+    QByteArray header(HeaderSize, '\0');
+    std::memcpy(header.data(), Magic, sizeof(Magic));
+    header[8] = static_cast<char>(Version);
+    writeValue<quint16>(header.data() + 10, RecordSize);
+    return header;
+}
+
+inline QByteArray dictionaryFileHeader()
+{
+    QByteArray header(HeaderSize, '\0');
+    std::memcpy(header.data(), DictionaryMagic, sizeof(DictionaryMagic));
+    header[8] = static_cast<char>(Version);
+    return header;
+}
+
+inline bool isRecordFileHeader(const QByteArray& data)
+{
+    return data.size() >= HeaderSize && std::memcmp(data.constData(), Magic, sizeof(Magic)) == 0 &&
+           static_cast<quint8>(data.at(8)) == Version &&
+           readValue<quint16>(data.constData() + 10) == RecordSize;
+}
+
+inline bool isDictionaryFileHeader(const QByteArray& data)
+{
+    return data.size() >= HeaderSize &&
+           std::memcmp(data.constData(), DictionaryMagic, sizeof(DictionaryMagic)) == 0 &&
+           static_cast<quint8>(data.at(8)) == Version;
+}
+
+} // namespace JournalFormat
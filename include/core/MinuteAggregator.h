@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ActivityMonitor.h"
+
+/**
+ * @brief 分钟聚合器
+ * 
+ * 将逐秒采样折叠为固定的一分钟桶：累计活跃秒数、点击/按键增量、按键间隔分布、
+ * 指针移动距离与速度、滚轮格数，并统计本分钟停留时间最长的窗口和应用程序。
+ * 只保存累加值，内存占用固定，不做动态分配。
+ */
+class MinuteAggregator
+{
+public:
+    MinuteAggregator();
+
+    /**
+     * @brief 加入一个采样
+     * 
+     * 采样落入新的一分钟时，上一分钟的桶写入 completed 并返回 true
+     */
+    bool add(qint64 timestampMs, bool isActive, int clickDelta, int keyDelta,
+             double pointerDistance, int wheelDelta, const LogHistogram& keyIntervals,
+             quint32 windowTitleId, quint32 applicationId,
+             ActivityMonitor::ActivityBucket* completed);
+
+    /**
+     * @brief 输出尚未完成的当前桶，没有数据时返回 false
+     */
+    bool flush(ActivityMonitor::ActivityBucket* completed);
+
+private:
+    void beginBucket(qint64 minuteStartMs);
+    void finishBucket(ActivityMonitor::ActivityBucket* completed);
+
+    static constexpr int MaxTracked = 8; // 每分钟跟踪的窗口数（应用程序数）上限
+
+    struct Dwell {
+        quint32 id;
+        int milliseconds;
+    };
+
+    static void addDwell(Dwell* dwells, int& count, quint32 id, int milliseconds);
+    static quint32 dominantId(const Dwell* dwells, int count);
+
+    bool m_hasBucket;
+    ActivityMonitor::ActivityBucket m_current;
+    int m_activeMilliseconds;
+    int m_movingMilliseconds;
+    qint64 m_lastTimestampMs;
+    Dwell m_windows[MaxTracked];
+    int m_windowCount;
+    Dwell m_applications[MaxTracked];
+    int m_applicationCount;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "InputSource.h"
+
+/**
+ * @brief 轮询输入后端
+ * 
+ * 用于没有事件接口的平台：Windows 下通过 GetAsyncKeyState/GetLastInputInfo 轮询，
+ * 全屏状态来自 SHQueryUserNotificationState；其他平台只提供模拟数据
+ */
+class PollingInputSource : public InputSource
+{
+    Q_OBJECT
+
+public:
+    explicit PollingInputSource(QObject *parent = nullptr);
+    ~PollingInputSource() override;
+
+    QString name() const override { return "polling"; }
+    bool open() override { return true; }
+    void close() override {}
+    bool isEventDriven() const override { return false; }
+    void poll() override;
+    Counters counters() const override { return m_counters; }
+    int idleMilliseconds() override;
+    QString activeWindowTitle() override;
+    qint64 activeWindowPid() override;
+    bool isActiveWindowFullscreen() const override { return m_fullscreen; }
+
+private:
+    void pollMouse();
+    void pollKeyboard();
+    void pollFullscreen();
+
+    Counters m_counters;
+    unsigned long m_lastMouseClickTime;
+    unsigned long m_lastKeystrokeTime;
+    int m_lastCursorX;
+    int m_lastCursorY;
+    bool m_fullscreen;
+};
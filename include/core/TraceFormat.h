@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief 活动轨迹文件格式
+ * 
+ * 文件头：8 字节魔数 "WWETRACE" + 1 字节版本号。
+ * 随后是连续的记录，每条记录以 1 字节类型开头，字段均为 zigzag 变长整数：
+ *   - RecordTitle:  traceId, 长度, UTF-8 字节  —— 定义轨迹内的窗口标题 ID
+ *   - RecordApplication: traceId, 长度, UTF-8 字节  —— 定义轨迹内的应用程序 ID（版本 3 起）
+ *   - RecordSample: 时间差(ms), 点击增量, 按键增量, 移动增量, 标题 traceId,
+ *                   指针距离增量(像素), 滚轮增量,  —— 这两项自版本 2 起
+ *                   应用程序 traceId,  —— 自版本 3 起
+ *                   变化的按键间隔桶数 n, n 组 (桶序号, 计数增量)  —— 自版本 4 起
+ * 时间与累计计数器均相对上一条采样做差分，一周的采样通常只有几 MB。
+ * 回放端兼容 MinVersion 到 Version 之间的所有版本。
+ */
+namespace TraceFormat {
+
+constexpr char Magic[8] = {'W', 'W', 'E', 'T', 'R', 'A', 'C', 'E'};
+constexpr quint8 Version = 4;
+constexpr quint8 MinVersion = 1;
+constexpr int HeaderSize = 9;
+
+enum RecordType : quint8 {
+    RecordSample = 1,
+    RecordTitle = 2,
+    RecordApplication = 3
+};
+
+inline void writeVarint(QByteArray& out, qint64 value)
+{
+    // zigzag 编码使小幅负值同样只占 1 字节
+    quint64 zigzag = (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+    while (zigzag >= 0x80) {
+        out.append(static_cast<char>((zigzag & 0x7f) | 0x80));
+        zigzag >>= 7;
+    }
+    out.append(static_cast<char>(zigzag));
+}
+
+inline bool readVarint(const QByteArray& in, int& pos, qint64& value)
+{
+    quint64 zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(in.at(pos++));
+        zigzag |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace TraceFormat
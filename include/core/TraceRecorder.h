@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include "ActivityCapture.h"
+#include "TraceFormat.h"
+
+/**
+ * @brief 活动轨迹录制器
+ * 
+ * 将 ActivityMonitor 处理的每个采样及窗口标题（焦点变化）写入紧凑的二进制轨迹文件，
+ * 供 TraceReplayer 回放，用于复现用户问题和对整条数据管线做压力测试。
+ * 格式见 TraceFormat.h。
+ */
+class TraceRecorder
+{
+public:
+    TraceRecorder();
+    ~TraceRecorder();
+
+    /**
+     * @brief 创建（覆盖）轨迹文件并写入文件头
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 刷新缓冲并关闭文件
+     */
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /**
+     * @brief 追加一个采样，首次出现的标题和应用程序会先写入定义
+     */
+    void record(const ActivityCapture::Sample& sample);
+
+    /**
+     * @brief 已录制的采样数
+     */
+    quint64 sampleCount() const { return m_sampleCount; }
+
+private:
+    void flush();
+    void writeDefinition(TraceFormat::RecordType type, quint32 id, const QString& value);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QSet<quint32> m_writtenTitles;
+    QSet<quint32> m_writtenApplications;
+    ActivityCapture::Sample m_previous;
+    quint64 m_sampleCount;
+};
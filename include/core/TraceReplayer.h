@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include "ActivityCapture.h"
+
+class ActivityMonitor;
+class QTimer;
+
+/**
+ * @brief 活动轨迹回放器
+ * 
+ * 读取 TraceRecorder 录制的轨迹，按原始时间间隔（1x）、加速（Nx）或尽快（最大速度）
+ * 将采样注入 ActivityMonitor，使 HealthEngine 与 DataAnalyzer 收到与实时会话相同的信号。
+ * 回放不依赖显示服务，同一轨迹多次回放得到相同的结果。
+ */
+class TraceReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr double MaxSpeed = 0.0;
+
+    explicit TraceReplayer(ActivityMonitor* monitor, QObject *parent = nullptr);
+    ~TraceReplayer();
+
+    /**
+     * @brief 读取轨迹文件并校验文件头
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief 设置回放速度：1 为实时，N 为 N 倍速，MaxSpeed 为不等待
+     */
+    void setSpeed(double speed);
+
+    /**
+     * @brief 开始回放，完成后发出 finished()
+     */
+    void start();
+
+    /**
+     * @brief 已回放的采样数
+     */
+    quint64 replayedSamples() const { return m_replayedSamples; }
+
+signals:
+    /**
+     * @brief 回放完成（或轨迹损坏而中止）时发出
+     */
+    void finished();
+
+private slots:
+    void replayNext();
+
+private:
+    bool readSample(ActivityCapture::Sample& sample);
+    bool readKeyIntervals(LogHistogram& histogram);
+
+    ActivityMonitor* m_monitor;
+    QTimer* m_timer;
+    double m_speed;
+
+    QByteArray m_data;
+    int m_position;
+    quint8 m_version;
+    QHash<qint64, quint32> m_titleIds; // 轨迹内标题 ID -> 本进程驻留池 ID
+    QHash<qint64, quint32> m_applicationIds; // 轨迹内应用程序 ID -> 本进程驻留池 ID
+    ActivityCapture::Sample m_decoded;  // 差分解码的基准（上一条读出的采样）
+    qint64 m_lastInjectedMs;
+    bool m_hasPending;
+    ActivityCapture::Sample m_pending;
+    quint64 m_replayedSamples;
+};
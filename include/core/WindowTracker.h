@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QString>
+
+// 仅前置声明 Xlib 类型，避免 X11 宏污染包含此头文件的代码
+typedef struct _XDisplay Display;
+typedef union _XEvent XEvent;
+
+/**
+ * @brief 活跃窗口跟踪器（X11）
+ * 
+ * 订阅根窗口 _NET_ACTIVE_WINDOW 及当前窗口 _NET_WM_NAME、_NET_WM_STATE 的 PropertyNotify 事件，
+ * 缓存当前活跃窗口标题、全屏状态与所属进程（_NET_WM_PID），读取时不产生任何 X 请求
+ */
+class WindowTracker
+{
+public:
+    /**
+     * @brief 使用已有的 X 连接构造，不会另开连接
+     */
+    explicit WindowTracker(Display* display);
+    ~WindowTracker();
+
+    /**
+     * @brief 安装进程级 X 错误处理函数，须在任何采集线程启动前调用；重复调用无效果
+     * 
+     * 只忽略 WindowTracker 所用连接上的错误，其他连接的错误交给原来的处理函数
+     */
+    static void installErrorHandler();
+
+    /**
+     * @brief 窗口管理器是否支持 _NET_ACTIVE_WINDOW（事件驱动）
+     * 
+     * 不支持时需由调用方定期调用 refresh()
+     */
+    bool isEventDriven() const { return m_eventDriven; }
+
+    /**
+     * @brief 处理一个 X 事件，返回该事件是否与窗口跟踪相关
+     */
+    bool handleEvent(const XEvent& event);
+
+    /**
+     * @brief 重新读取活跃窗口及其标题
+     */
+    void refresh();
+
+    /**
+     * @brief 获取缓存的活跃窗口标题
+     */
+    QString activeWindowTitle() const { return m_activeTitle; }
+
+    /**
+     * @brief 活跃窗口是否处于全屏状态（_NET_WM_STATE_FULLSCREEN，演示、视频、游戏等）
+     */
+    bool isActiveWindowFullscreen() const { return m_activeFullscreen; }
+
+    /**
+     * @brief 活跃窗口所属进程 ID（_NET_WM_PID），窗口未设置该属性时返回 0
+     */
+    qint64 activeWindowPid() const { return m_activePid; }
+
+    /**
+     * @brief 获取当前活跃窗口 ID
+     */
+    unsigned long activeWindow() const { return m_activeWindow; }
+
+private:
+    unsigned long queryActiveWindow(bool* supported) const;
+    QString fetchTitle(unsigned long window) const;
+    bool fetchFullscreen(unsigned long window) const;
+    qint64 fetchPid(unsigned long window) const;
+    void setActiveWindow(unsigned long window);
+
+    Display* m_display;
+    unsigned long m_root;
+    unsigned long m_activeWindow;
+    QString m_activeTitle;
+    bool m_activeFullscreen;
+    qint64 m_activePid;
+    bool m_eventDriven;
+
+    // 预先获取的 Atom
+    unsigned long m_netActiveWindowAtom;
+    unsigned long m_netWmNameAtom;
+    unsigned long m_utf8StringAtom;
+    unsigned long m_netWmStateAtom;
+    unsigned long m_netWmStateFullscreenAtom;
+    unsigned long m_netWmPidAtom;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "InputSource.h"
+
+/**
+ * @brief X11 输入后端
+ * 
+ * 优先通过 XInput2 原始事件（XI_RawKeyPress/XI_RawButtonPress/XI_RawMotion）精确计数，
+ * 相对移动设备的 X/Y 轴增量累加为指针移动距离，
+ * 由 X 连接上的 QSocketNotifier 驱动；服务器不支持 XInput2 时退回
+ * XQueryPointer/XQueryKeymap 轮询。轮询模式使用独立的高频计时器，
+ * 通过比较前后两次按键位图只统计新按下的键，长时间无输入时降频。
+ * 空闲状态由 XSync IDLETIME 计数器上的正/负跃迁报警通知，无需定时检查；
+ * 锁屏与屏保由 MIT-SCREEN-SAVER 的 ScreenSaverNotify 事件通知。
+ * 活跃窗口标题与全屏状态由 WindowTracker 缓存。
+ */
+class X11InputSource : public InputSource
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param displayName X 显示名（如 ":12"），为空时使用 $DISPLAY
+     */
+    explicit X11InputSource(const QString& displayName = QString(), QObject *parent = nullptr);
+    ~X11InputSource() override;
+
+    QString name() const override { return "x11"; }
+    bool open() override;
+    void close() override;
+    bool isEventDriven() const override;
+    void poll() override;
+    Counters counters() const override;
+    int idleMilliseconds() override;
+    QString activeWindowTitle() override;
+    qint64 activeWindowPid() override;
+    bool isActiveWindowFullscreen() const override;
+    bool isScreenLocked() const override;
+    bool setIdleThreshold(int thresholdMs) override;
+
+private:
+    void initializeRawInput();
+    void initializeIdleCounter();
+    void initializeScreenSaverNotify();
+    void handleScreenSaverNotify(int state);
+    void handleAlarm(unsigned long alarm);
+    void updateFullscreenState();
+    void processPendingEvents();
+    void pollInput();
+    int pollPointer();
+    int pollKeymap();
+
+    // 平台相关的私有数据
+    class Private;
+    std::unique_ptr<Private> d;
+};
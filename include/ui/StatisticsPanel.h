@@ -44,5 +44,6 @@ private:
     QLabel* m_totalBreaksLabel;
     QLabel* m_longestSessionLabel;
     QLabel* m_healthScoreLabel;
+    QLabel* m_typingCadenceLabel;
     QPushButton* m_refreshButton;
 };
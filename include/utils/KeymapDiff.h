@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * @brief 键盘位图边沿检测
+ * 
+ * 比较前后两次 256 位按键位图（XQueryKeymap 格式，32 字节），
+ * 统计新按下的键数：popcount(current & ~previous)。
+ * 按编译目标选择 AVX2 / SSE2 / 标量实现，结果一致。
+ */
+class KeymapDiff
+{
+public:
+    static constexpr int Bytes = 32;
+
+    /**
+     * @brief 统计 current 中置位而 previous 中未置位的位数
+     */
+    static int countNewlyPressed(const unsigned char* previous, const unsigned char* current);
+
+    /**
+     * @brief 当前编译使用的实现名称（"avx2"、"sse2" 或 "scalar"）
+     */
+    static const char* implementation();
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @brief 固定内存的对数刻度时间间隔直方图
+ * 
+ * 32 个四分之一倍频程桶覆盖 8ms 到 2s：桶 b 的下界为 8 * 2^(b/4) 毫秒，
+ * 小于 8ms 的间隔计入第一个桶，超过 MaxIntervalMs 的间隔视为停顿而不记录。
+ * 桶边界固定，不同时间段的直方图逐桶相加即可合并，不做动态分配。
+ */
+class LogHistogram
+{
+public:
+    static constexpr int BucketCount = 32;
+    static constexpr qint64 MinIntervalMs = 8;
+    static constexpr qint64 MaxIntervalMs = 2000;
+
+    /**
+     * @brief 记录一个间隔（毫秒），负值或超过 MaxIntervalMs 的间隔被忽略
+     */
+    void addInterval(qint64 intervalMs)
+    {
+        if (intervalMs >= 0 && intervalMs <= MaxIntervalMs) {
+            m_counts[bucketFor(intervalMs)]++;
+        }
+    }
+
+    /**
+     * @brief 逐桶累加另一个直方图
+     */
+    void merge(const LogHistogram& other);
+
+    /**
+     * @brief 本直方图减去较早的累计快照，得到期间新增的分布
+     */
+    LogHistogram since(const LogHistogram& earlier) const;
+
+    /**
+     * @brief 第 p 百分位（0-100）所在桶的几何中点（毫秒），没有数据时返回 0
+     */
+    double percentile(double p) const;
+
+    quint32 count(int bucket) const { return m_counts[bucket]; }
+    void setCount(int bucket, quint32 count) { m_counts[bucket] = count; }
+    quint64 total() const;
+    bool isEmpty() const { return total() == 0; }
+
+    /**
+     * @brief 间隔所在的桶序号
+     */
+    static int bucketFor(qint64 intervalMs);
+
+    /**
+     * @brief 桶的下界（毫秒）
+     */
+    static double bucketLowerBound(int bucket);
+
+private:
+    std::array<quint32, BucketCount> m_counts{};
+};
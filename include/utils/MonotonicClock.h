@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @brief 进程级时间源
+ * 
+ * 热路径只读取单调时钟（Linux 下为 CLOCK_MONOTONIC_COARSE，精度约为一个时钟节拍），
+ * 不经过时区换算；需要墙上时间时由缓存的偏移量换算为 Unix 毫秒，
+ * 转换为 QDateTime 只应发生在持久化和界面显示处。
+ * 单调时钟不包含系统挂起时间，suspendedNanoseconds() 用于检测挂起/恢复。
+ * 线程安全。
+ */
+class MonotonicClock
+{
+public:
+    /**
+     * @brief 单调时间（纳秒），不包含挂起时间，只用于计算时间间隔
+     */
+    static qint64 nanoseconds();
+
+    /**
+     * @brief 单调时间（毫秒）
+     */
+    static qint64 milliseconds() { return nanoseconds() / 1000000; }
+
+    /**
+     * @brief 当前墙上时间（Unix 毫秒），由缓存偏移换算，每分钟与系统时钟重新对齐一次
+     */
+    static qint64 currentUnixMs();
+
+    /**
+     * @brief 开机以来系统处于挂起状态的累计时长（纳秒），平台不支持时恒为 0
+     * 
+     * 两次读数之差大于零即说明期间发生过挂起
+     */
+    static qint64 suspendedNanoseconds();
+
+    /**
+     * @brief 立即与系统墙上时钟重新对齐（恢复或系统时间调整后调用）
+     */
+    static void resynchronize();
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief 进程 → 应用程序映射缓存
+ * 
+ * 按 PID 解析所属应用程序名（Linux 读取 /proc/<pid>/exe 与 comm，Windows 读取映像路径），
+ * 并驻留到 StringInternPool::applications()。每个进程只解析一次；
+ * 缓存项记录进程启动时间，PID 被新进程复用时自动失效，已退出进程的缓存项在缓存增长时清理。
+ * 线程安全。
+ */
+class ProcessInfoCache
+{
+public:
+    /**
+     * @brief 进程级缓存
+     */
+    static ProcessInfoCache& instance();
+
+    /**
+     * @brief 获取进程所属应用程序的 ID，PID 无效或进程不可访问时返回 StringInternPool::EmptyId
+     */
+    quint32 applicationId(qint64 pid);
+
+    /**
+     * @brief 缓存的进程数
+     */
+    int size() const;
+
+private:
+    ProcessInfoCache() = default;
+
+    void pruneExited();
+
+    struct Entry {
+        quint64 startTime;     // 进程启动时间，用于识别 PID 复用
+        quint32 applicationId;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<qint64, Entry> m_entries;
+};
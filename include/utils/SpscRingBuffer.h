@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief 单生产者/单消费者无锁环形缓冲区
+ * 
+ * 仅允许一个线程调用 tryPush()，另一个线程调用 tryPop()。
+ * 容量必须是 2 的幂，槽位在构造时一次性分配，之后不再分配内存。
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+
+public:
+    /**
+     * @brief 生产者写入一个元素，缓冲区已满时返回 false
+     */
+    bool tryPush(const T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_slots[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者取出一个元素，缓冲区为空时返回 false
+     */
+    bool tryPop(T& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[tail & (Capacity - 1)]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 当前队列深度（任意线程调用时为近似值）
+     */
+    std::size_t size() const
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    // 读写索引分处不同缓存行，避免生产者与消费者伪共享
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::array<T, Capacity> m_slots{};
+};
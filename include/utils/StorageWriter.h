@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPromise>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+
+/**
+ * @brief 共享的异步文件写入器
+ * 
+ * 多个数据分析实例（如多显示器模式下每个显示器一个）共用一个有界线程池写盘，
+ * 调用方只需在 GUI 线程序列化数据。同一路径尚未写完时的新内容只保留最新一份，
+ * 且同一路径同时只有一个写任务，保证最终落盘的是最后一次提交的内容。
+ * 整体写入通过 QSaveFile 原子替换目标文件；追加写入按提交顺序拼接后追加到文件末尾。线程安全。
+ * 每次提交返回落盘结果，合并写入的提交共享同一结果；追加失败时文件尾部可能留有部分数据，由调用方截断。
+ */
+class StorageWriter
+{
+public:
+    explicit StorageWriter(int maxThreads = 2);
+    ~StorageWriter();
+
+    /**
+     * @brief 提交一次写入，立即返回；结果为最终替换该文件的那次写入是否成功
+     */
+    QFuture<bool> write(const QString& filePath, const QByteArray& data);
+
+    /**
+     * @brief 提交一次追加写入，立即返回；同一路径的追加按提交顺序落盘，结果在数据刷到磁盘后为 true
+     */
+    QFuture<bool> append(const QString& filePath, const QByteArray& data);
+
+    /**
+     * @brief 等待所有已提交的写入完成
+     */
+    void waitForDone();
+
+    /**
+     * @brief 同步写入文件（原子替换），失败时返回 false
+     */
+    static bool writeFile(const QString& filePath, const QByteArray& data);
+
+    /**
+     * @brief 同步追加到文件末尾（文件不存在时创建）并把数据刷到磁盘，失败时返回 false
+     */
+    static bool appendFile(const QString& filePath, const QByteArray& data);
+
+private:
+    struct PendingWrite {
+        QByteArray data;
+        bool append = false; // true 时追加到文件末尾，否则整体替换
+        QList<std::shared_ptr<QPromise<bool>>> results; // 合并进本次写入的各次提交
+    };
+
+    QFuture<bool> submit(const QString& filePath, const QByteArray& data, bool append);
+    void drain(const QString& filePath);
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QHash<QString, PendingWrite> m_pending; // 路径 -> 待写入的内容
+    QSet<QString> m_inFlight;             // 已有写任务的路径
+};
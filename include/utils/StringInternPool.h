@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+/**
+ * @brief 字符串驻留池
+ * 
+ * 为重复出现的字符串（如窗口标题、应用程序名）分配稳定的 32 位 ID，
+ * 采集端只传递 ID，仅在显示或导出时再解析为字符串。
+ * ID 0 固定表示空字符串；ID 仅在进程内有效，持久化时需连同字典一起保存。
+ * 字符串按原样保存。池的大小有上限：满了以后回收最近没有再驻留过的字符串，
+ * ID 不会复用，已回收的 ID 解析为空字符串。
+ * 窗口标题池按规范化后的标题（见 normalizeTitle()）归族：同族的不同原文最多保存 MaxTitleVariants 个，
+ * 之后每秒变化的标题（播放进度、时钟、下载进度等）沿用同族最近保存的 ID。
+ * 线程安全。
+ */
+class StringInternPool
+{
+public:
+    static constexpr quint32 EmptyId = 0;
+    static constexpr int MaxTitles = 16384;          // 窗口标题池的容量（含空字符串）
+    static constexpr int MaxApplications = 4096;     // 应用程序名池的容量（含空字符串）
+    static constexpr int MaxTitleLength = 256;       // 驻留的窗口标题最多保留的字符数
+    static constexpr int MaxTitleVariants = 8;       // 规范化后相同的标题最多保存的不同原文
+
+    /**
+     * @brief 进程级窗口标题池
+     */
+    static StringInternPool& titles();
+
+    /**
+     * @brief 进程级应用程序名池
+     */
+    static StringInternPool& applications();
+
+    /**
+     * @brief 获取字符串对应的 ID，不存在时分配新 ID；池已满时先回收长期未用的字符串
+     */
+    quint32 intern(const QString& value);
+
+    /**
+     * @brief 将 ID 解析为字符串，未知或已回收的 ID 返回空字符串
+     */
+    QString resolve(quint32 id) const;
+
+    /**
+     * @brief 当前驻留的字符串数量（含空字符串）
+     */
+    int size() const;
+
+    /**
+     * @brief 池的容量（含空字符串）
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief 窗口标题的归族键：连续的数字折叠为一个 "#"，空白合并
+     * 
+     * 如 "Downloading 45% (1.2 MB/s)" 与 "Downloading 46% (1.3 MB/s)" 都得到 "Downloading #% (#.# MB/s)"。
+     * 只用于查找同族标题，保存的仍是原文
+     */
+    static QString normalizeTitle(const QString& title);
+
+private:
+    using Normalizer = QString (*)(const QString&);
+
+    struct Entry {
+        quint32 id = EmptyId;
+        quint32 generation = 0;     // 最近一次驻留时的代
+        QString familyKey;          // 归族键，没有归族时为空
+    };
+
+    struct Family {
+        int variants = 0;           // 已保存的不同原文数
+        quint32 latestId = EmptyId; // 最近保存的原文
+    };
+
+    StringInternPool(int capacity, Normalizer normalizer);
+
+    void evictLocked();
+
+    const int m_capacity;
+    const Normalizer m_normalizer;  // 为空时不归族，也不截断
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Entry> m_entries;   // 原文 -> 条目
+    QHash<quint32, QString> m_strings; // ID -> 原文
+    QHash<QString, Family> m_families; // 归族键 -> 同族的原文
+    quint32 m_nextId;
+    quint32 m_generation;              // 每分配容量的四分之一个 ID 加一
+};
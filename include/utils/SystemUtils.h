@@ -19,10 +19,17 @@ public:
     static QString getActiveWindowTitle();
 
     /**
-     * @brief 获取当前活跃应用程序名称
+     * @brief 获取当前活跃应用程序名称（可执行文件名）
+     * 
+     * 活动采集运行时读取其发布的应用程序 ID；否则 Windows 下直接查询前台进程，其他平台返回空字符串
      */
     static QString getActiveApplicationName();
 
+    /**
+     * @brief 发布活跃应用程序 ID（StringInternPool::applications()），由默认显示的活动采集线程调用
+     */
+    static void setActiveApplicationId(quint32 applicationId);
+
     /**
      * @brief 获取系统空闲时间（毫秒）
      */
@@ -39,10 +46,18 @@ public:
     static QPoint getMousePosition();
 
     /**
-     * @brief 检查是否为全屏应用
+     * @brief 当前活跃窗口是否全屏（演示、视频、游戏等）
+     * 
+     * 只读取活动采集线程发布的缓存状态（X11 下来自 _NET_WM_STATE_FULLSCREEN），
+     * 不产生任何窗口系统请求
      */
     static bool isFullscreenApplication();
 
+    /**
+     * @brief 发布全屏状态，由默认显示的活动采集线程在状态变化时调用
+     */
+    static void setFullscreenApplication(bool fullscreen);
+
     /**
      * @brief 设置开机自启动
      */
@@ -0,0 +1,323 @@
+#include "core/ActivityCapture.h"
+#include "core/InputSource.h"
+#include "utils/Logger.h"
+#include "utils/MonotonicClock.h"
+#include "utils/ProcessInfoCache.h"
+#include "utils/StringInternPool.h"
+#include "utils/SystemUtils.h"
+#include <QTimer>
+
+namespace {
+
+// 空闲时的采样间隔阶梯：{空闲时长下限, 采样间隔}，按空闲时长递增。
+// 只用于不能主动通知空闲的后端（轮询、evdev）；XSync 报警等后端在越过空闲阈值（默认 30 秒）
+// 时直接暂停采样，不会走到阶梯的第二级
+struct SamplingStep {
+    int idleMs;
+    int intervalMs;
+};
+
+constexpr int kBaseIntervalMs = 1000;
+constexpr int kDefaultIdleThresholdMs = 30 * 1000;
+constexpr SamplingStep kSamplingSteps[] = {
+    {0,              kBaseIntervalMs},
+    {60 * 1000,      5 * 1000},
+    {5 * 60 * 1000,  30 * 1000},
+    {15 * 60 * 1000, 60 * 1000},
+};
+
+int intervalForIdleTime(int idleMs)
+{
+    int interval = kBaseIntervalMs;
+    for (const SamplingStep& step : kSamplingSteps) {
+        if (idleMs >= step.idleMs) {
+            interval = step.intervalMs;
+        }
+    }
+    return interval;
+}
+
+} // namespace
+
+class ActivityCapture::Private
+{
+public:
+    std::unique_ptr<InputSource> source;
+
+    // 标题未变化时直接复用 ID，只在切换窗口时查询驻留池
+    QString lastWindowTitle;
+    quint32 lastWindowTitleId = StringInternPool::EmptyId;
+
+    // 同理，活跃窗口所属进程变化时才解析应用程序
+    qint64 lastPid = 0;
+    quint32 lastApplicationId = StringInternPool::EmptyId;
+};
+
+ActivityCapture::ActivityCapture(SampleRing* ring, const QString& displayName, QObject *parent)
+    : QObject(parent)
+    , m_ring(ring)
+    , m_displayName(displayName)
+    , m_timer(nullptr)
+    , m_running(false)
+    , m_idleSuspended(false)
+    , m_suspendedAtMs(0)
+    , m_idleThresholdMs(kDefaultIdleThresholdMs)
+    , d(std::make_unique<Private>())
+{
+}
+
+ActivityCapture::~ActivityCapture()
+{
+    if (d->source) {
+        d->source->close();
+    }
+}
+
+void ActivityCapture::initialize()
+{
+    // 计时器与输入后端的套接字通知器必须在采集线程中创建
+    m_timer = new QTimer(this);
+    m_timer->setInterval(kBaseIntervalMs); // 活跃时每秒采样一次，空闲时由 adjustSamplingRate() 退避
+    connect(m_timer, &QTimer::timeout, this, &ActivityCapture::captureSample);
+
+    initializeInputSource();
+}
+
+void ActivityCapture::initializeInputSource()
+{
+    // 指定显示时只能使用该显示的 X 连接，本机 evdev 设备属于其他用户
+    const QStringList backends = m_displayName.isEmpty()
+        ? InputSource::candidateBackends()
+        : QStringList() << "x11";
+    for (const QString& backend : backends) {
+        std::unique_ptr<InputSource> source = InputSource::create(backend, m_displayName);
+        if (!source) {
+            Logger::warning(QString("未知的输入后端: %1").arg(backend), "ActivityCapture");
+            continue;
+        }
+        if (source->open()) {
+            d->source = std::move(source);
+            break;
+        }
+    }
+
+    if (!d->source) {
+        Logger::error("没有可用的输入后端，无法监测用户活动", "ActivityCapture");
+        return;
+    }
+
+    // 空闲退避期间的第一次输入立即恢复全速采样
+    connect(d->source.get(), &InputSource::inputReceived, this, &ActivityCapture::restoreFullSamplingRate);
+    connect(d->source.get(), &InputSource::idleStateChanged, this, &ActivityCapture::onSourceIdleStateChanged);
+    connect(d->source.get(), &InputSource::fullscreenChanged, this, &ActivityCapture::onSourceFullscreenChanged);
+    connect(d->source.get(), &InputSource::screenLockChanged, this, &ActivityCapture::onSourceScreenLockChanged);
+    if (d->source->isActiveWindowFullscreen()) {
+        onSourceFullscreenChanged(true);
+    }
+    if (d->source->isScreenLocked()) {
+        onSourceScreenLockChanged(true);
+    }
+    m_idleNotifications.store(d->source->setIdleThreshold(m_idleThresholdMs), std::memory_order_relaxed);
+    Logger::info(QString("使用输入后端: %1").arg(d->source->name()), "ActivityCapture");
+}
+
+void ActivityCapture::start()
+{
+    m_running = true;
+    m_idleSuspended = false;
+    if (m_timer) {
+        m_timer->start(kBaseIntervalMs);
+        m_samplingIntervalMs.store(kBaseIntervalMs, std::memory_order_relaxed);
+    }
+}
+
+void ActivityCapture::stop()
+{
+    if (m_idleSuspended) {
+        countSuspendedWakeups();
+        m_idleSuspended = false;
+    }
+    m_running = false;
+    if (m_timer) {
+        m_timer->stop();
+    }
+}
+
+void ActivityCapture::setIdleThreshold(int thresholdMs)
+{
+    m_idleThresholdMs = thresholdMs;
+    if (d->source) {
+        m_idleNotifications.store(d->source->setIdleThreshold(thresholdMs), std::memory_order_relaxed);
+    }
+}
+
+void ActivityCapture::captureSample()
+{
+    if (!d->source) {
+        return;
+    }
+
+    d->source->poll();
+    const InputSource::Counters counters = d->source->counters();
+
+    Sample sample;
+    sample.timestampMs = MonotonicClock::currentUnixMs();
+    sample.mouseClicks = counters.mouseClicks;
+    sample.keystrokes = counters.keystrokes;
+    sample.motionEvents = counters.motionEvents;
+    sample.pointerDistance = counters.pointerDistance;
+    sample.wheelTicks = counters.wheelTicks;
+    sample.keyIntervals = counters.keyIntervals;
+    sample.windowTitleId = getCurrentWindowTitleId();
+    sample.applicationId = getCurrentApplicationId();
+
+    publish(sample);
+    adjustSamplingRate(d->source->idleMilliseconds());
+}
+
+void ActivityCapture::adjustSamplingRate(int idleMs)
+{
+    const int current = m_timer->interval();
+
+    // 本次唤醒替代了 current/1000 次固定频率唤醒
+    if (current > kBaseIntervalMs) {
+        m_wakeupsSaved.fetch_add(current / kBaseIntervalMs - 1, std::memory_order_relaxed);
+    }
+
+    if (idleMs < 0) {
+        return; // 平台无法提供空闲时间，保持固定频率
+    }
+    if (hasIdleNotifications()) {
+        return; // 空闲由后端通知并暂停采样，阈值之前保持每秒采样
+    }
+
+    const int interval = intervalForIdleTime(idleMs);
+    if (interval != current) {
+        m_timer->setInterval(interval);
+        m_samplingIntervalMs.store(interval, std::memory_order_relaxed);
+        Logger::debug(QString("采样间隔调整为 %1 ms（空闲 %2 ms）").arg(interval).arg(idleMs), "ActivityCapture");
+    }
+}
+
+void ActivityCapture::restoreFullSamplingRate()
+{
+    if (m_idleSuspended) {
+        resumeSampling();
+        return;
+    }
+    if (m_timer && m_timer->isActive() && m_timer->interval() != kBaseIntervalMs) {
+        m_timer->start(kBaseIntervalMs);
+        m_samplingIntervalMs.store(kBaseIntervalMs, std::memory_order_relaxed);
+    }
+}
+
+void ActivityCapture::onSourceIdleStateChanged(bool idle)
+{
+    if (idle) {
+        suspendSampling();
+    } else {
+        resumeSampling();
+    }
+    emit idleStateChanged(idle);
+}
+
+void ActivityCapture::onSourceFullscreenChanged(bool fullscreen)
+{
+    m_fullscreen.store(fullscreen, std::memory_order_relaxed);
+    if (m_displayName.isEmpty()) {
+        SystemUtils::setFullscreenApplication(fullscreen);
+    }
+    Logger::debug(fullscreen ? "活跃窗口进入全屏" : "活跃窗口退出全屏", "ActivityCapture");
+    emit fullscreenChanged(fullscreen);
+}
+
+void ActivityCapture::onSourceScreenLockChanged(bool locked)
+{
+    if (locked) {
+        m_screenLocked.store(true, std::memory_order_relaxed);
+        suspendSampling();
+    } else {
+        m_screenLocked.store(false, std::memory_order_relaxed);
+        resumeSampling();
+    }
+    emit screenLockChanged(locked);
+}
+
+void ActivityCapture::suspendSampling()
+{
+    if (!m_running || m_idleSuspended) {
+        return;
+    }
+    // 最后采样一次以提交空闲前的计数，之后不再唤醒，直到后端通知恢复
+    captureSample();
+    m_timer->stop();
+    m_idleSuspended = true;
+    m_suspendedAtMs = MonotonicClock::milliseconds();
+    Logger::debug(isScreenLocked() ? "屏幕锁定，暂停采样" : "用户空闲，暂停采样", "ActivityCapture");
+}
+
+void ActivityCapture::resumeSampling()
+{
+    // 锁屏界面上的输入（输入密码）不算恢复活跃
+    if (!m_running || !m_idleSuspended || isScreenLocked()) {
+        return;
+    }
+    countSuspendedWakeups();
+    m_idleSuspended = false;
+    m_timer->start(kBaseIntervalMs);
+    m_samplingIntervalMs.store(kBaseIntervalMs, std::memory_order_relaxed);
+    captureSample();
+    Logger::debug("用户恢复活跃，恢复采样", "ActivityCapture");
+}
+
+void ActivityCapture::countSuspendedWakeups()
+{
+    // 暂停期间固定 1 秒采样本应唤醒的次数（单调时钟不含系统挂起时间）
+    const qint64 suspendedMs = MonotonicClock::milliseconds() - m_suspendedAtMs;
+    if (suspendedMs > 0) {
+        m_wakeupsSaved.fetch_add(quint64(suspendedMs / kBaseIntervalMs), std::memory_order_relaxed);
+    }
+}
+
+void ActivityCapture::publish(const Sample& sample)
+{
+    if (!m_ring->tryPush(sample)) {
+        // 消费者跟不上：丢弃本次采样并计数，累计计数器保证下次采样不丢失输入
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_samplesCaptured.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const int depth = static_cast<int>(m_ring->size());
+    if (depth > m_maxQueueDepth.load(std::memory_order_relaxed)) {
+        m_maxQueueDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    // 合并通知：消费者取空之前不重复投递
+    if (!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit samplesAvailable();
+    }
+}
+
+quint32 ActivityCapture::getCurrentWindowTitleId()
+{
+    QString title = d->source->activeWindowTitle();
+    if (title != d->lastWindowTitle) {
+        d->lastWindowTitleId = StringInternPool::titles().intern(title);
+        d->lastWindowTitle = title;
+    }
+    return d->lastWindowTitleId;
+}
+
+quint32 ActivityCapture::getCurrentApplicationId()
+{
+    const qint64 pid = d->source->activeWindowPid();
+    if (pid != d->lastPid) {
+        d->lastPid = pid;
+        d->lastApplicationId = ProcessInfoCache::instance().applicationId(pid);
+        if (m_displayName.isEmpty()) {
+            SystemUtils::setActiveApplicationId(d->lastApplicationId);
+        }
+    }
+    return d->lastApplicationId;
+}
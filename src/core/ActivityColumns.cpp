@@ -0,0 +1,138 @@
+#include "core/ActivityColumns.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 kMaxSecondOffset = 0xffff;
+
+// 累计计数的增量；第一条记录没有基准记为 0，计数回退（采集重启）时从 0 重新累计
+quint16 counterDelta(int current, int* last)
+{
+    const int delta = *last < 0 ? 0 : (current >= *last ? current - *last : current);
+    *last = current;
+    return static_cast<quint16>(qBound(0, delta, 0xffff));
+}
+
+} // namespace
+
+ActivityColumns::Chunk& ActivityColumns::chunkFor(qint64 timestampSecs)
+{
+    // 块满、时间回退或超出 16 位偏移范围时另起一块
+    if (!m_chunks.isEmpty()) {
+        Chunk& last = m_chunks.last();
+        const qint64 offset = timestampSecs - last.baseSecs;
+        if (last.size() < ChunkSize && offset >= 0 && offset <= kMaxSecondOffset) {
+            return last;
+        }
+    }
+
+    Chunk& chunk = m_chunks.emplaceBack();
+    chunk.baseSecs = timestampSecs;
+    chunk.secondOffsets.reserve(ChunkSize);
+    chunk.activeBits.reserve(ChunkSize / 64);
+    chunk.mouseClicks.reserve(ChunkSize);
+    chunk.keystrokes.reserve(ChunkSize);
+    return chunk;
+}
+
+void ActivityColumns::append(const ActivityMonitor::ActivityData& data)
+{
+    const qint64 timestampSecs = data.timestamp.toSecsSinceEpoch();
+    Chunk& chunk = chunkFor(timestampSecs);
+    const int index = chunk.size();
+
+    chunk.secondOffsets.append(static_cast<quint16>(timestampSecs - chunk.baseSecs));
+    if (index % 64 == 0) {
+        chunk.activeBits.append(0);
+    }
+    if (data.isActive) {
+        chunk.activeBits.last() |= quint64(1) << (index % 64);
+    }
+    chunk.mouseClicks.append(counterDelta(data.mouseClicks, &m_lastMouseClicks));
+    chunk.keystrokes.append(counterDelta(data.keystrokes, &m_lastKeystrokes));
+
+    if (chunk.idRuns.isEmpty() || chunk.idRuns.last().windowTitleId != data.windowTitleId ||
+        chunk.idRuns.last().applicationId != data.applicationId) {
+        chunk.idRuns.append({index, data.windowTitleId, data.applicationId});
+    }
+    m_size++;
+}
+
+void ActivityColumns::clear()
+{
+    m_chunks.clear();
+    m_size = 0;
+    m_lastMouseClicks = -1;
+    m_lastKeystrokes = -1;
+}
+
+ActivityColumns::Sample ActivityColumns::at(int index) const
+{
+    Sample sample;
+    for (const Chunk& chunk : m_chunks) {
+        if (index >= chunk.size()) {
+            index -= chunk.size();
+            continue;
+        }
+
+        sample.timestampSecs = chunk.baseSecs + chunk.secondOffsets.at(index);
+        sample.isActive = (chunk.activeBits.at(index / 64) >> (index % 64)) & 1;
+        sample.mouseClicks = chunk.mouseClicks.at(index);
+        sample.keystrokes = chunk.keystrokes.at(index);
+
+        auto run = std::upper_bound(chunk.idRuns.cbegin(), chunk.idRuns.cend(), index,
+                                    [](int i, const IdRun& r) { return i < r.first; });
+        --run;
+        sample.windowTitleId = run->windowTitleId;
+        sample.applicationId = run->applicationId;
+        break;
+    }
+    return sample;
+}
+
+int ActivityColumns::activeCount() const
+{
+    int count = 0;
+    for (const Chunk& chunk : m_chunks) {
+        for (quint64 bits : chunk.activeBits) {
+            count += qPopulationCount(bits);
+        }
+    }
+    return count;
+}
+
+qint64 ActivityColumns::totalMouseClicks() const
+{
+    qint64 total = 0;
+    for (const Chunk& chunk : m_chunks) {
+        for (quint16 clicks : chunk.mouseClicks) {
+            total += clicks;
+        }
+    }
+    return total;
+}
+
+qint64 ActivityColumns::totalKeystrokes() const
+{
+    qint64 total = 0;
+    for (const Chunk& chunk : m_chunks) {
+        for (quint16 keystrokes : chunk.keystrokes) {
+            total += keystrokes;
+        }
+    }
+    return total;
+}
+
+qint64 ActivityColumns::memoryUsage() const
+{
+    qint64 bytes = m_chunks.capacity() * qint64(sizeof(Chunk));
+    for (const Chunk& chunk : m_chunks) {
+        bytes += chunk.secondOffsets.capacity() * qint64(sizeof(quint16));
+        bytes += chunk.activeBits.capacity() * qint64(sizeof(quint64));
+        bytes += chunk.mouseClicks.capacity() * qint64(sizeof(quint16));
+        bytes += chunk.keystrokes.capacity() * qint64(sizeof(quint16));
+        bytes += chunk.idRuns.capacity() * qint64(sizeof(IdRun));
+    }
+    return bytes;
+}
@@ -0,0 +1,1190 @@
+#include "core/ActivityJournal.h"
+#include "utils/Logger.h"
+#include "utils/StorageWriter.h"
+#include "utils/StringInternPool.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <array>
+
+using namespace JournalFormat;
+
+namespace {
+
+constexpr char kSegmentSuffix[] = ".seg";
+constexpr char kDictionaryFileName[] = "strings.dict";
+constexpr char kManifestFileName[] = "manifest.json";
+constexpr int kManifestVersion = 1;
+
+// 无法识别的文件改名保留，不覆盖也不删除
+void moveAside(const QString& path)
+{
+    const QString target = path + ".corrupt";
+    QFile::remove(target);
+    QFile::rename(path, target);
+    Logger::warning(QString("日志文件头无法识别，已移至 %1").arg(target), "ActivityJournal");
+}
+
+void addSummary(ActivityJournal::DaySummary* into, const ActivityJournal::DaySummary& from)
+{
+    into->records += from.records;
+    into->buckets += from.buckets;
+    into->activeSeconds += from.activeSeconds;
+    into->activeSamples += from.activeSamples;
+    into->mouseClicks += from.mouseClicks;
+    into->keystrokes += from.keystrokes;
+    into->breaks += from.breaks;
+    into->longestSittingMs = qMax(into->longestSittingMs, from.longestSittingMs);
+    into->healthEvents += from.healthEvents;
+}
+
+constexpr qint64 kMinuteMs = 60 * 1000;
+
+// 压缩中的一个时间段（分钟或小时）；标题与应用程序保持文件内 ID，原样写回，不经过驻留池
+struct Rollup {
+    qint64 startMs = 0;
+    qint32 activeSeconds = 0;
+    qint32 mouseClicks = 0;
+    qint32 keystrokes = 0;
+    qint32 wheelTicks = 0;
+    double pointerDistance = 0.0;
+    double peakVelocity = 0.0;
+    double movingSeconds = 0.0;       // 指针移动期间的总时长，用于重新计算平均速度
+    QHash<quint64, qint64> dwell;     // (标题 << 32 | 应用程序) -> 停留秒数
+    std::array<quint32, LogHistogram::BucketCount> keyIntervals{};
+};
+
+qint64 localHourStart(qint64 timestampMs)
+{
+    QDateTime time = QDateTime::fromMSecsSinceEpoch(timestampMs);
+    time.setTime(QTime(time.time().hour(), 0));
+    return time.toMSecsSinceEpoch();
+}
+
+// 累计计数的增量，计数回退（采集重启）时从 0 重新累计
+qint32 counterDelta(qint32 current, qint32* last)
+{
+    const qint32 delta = *last < 0 ? 0 : (current >= *last ? current - *last : current);
+    *last = current;
+    return delta;
+}
+
+// 逐秒记录并入分钟汇总；点击与按键为累计计数，按相邻记录的增量累加
+void addActivity(Rollup* rollup, const char* p, qint32* lastClicks, qint32* lastKeystrokes)
+{
+    const double distance = JournalFormat::readDouble(p + 24);
+    const double velocity = JournalFormat::readDouble(p + 32);
+    rollup->activeSeconds += p[44] != 0 ? 1 : 0;
+    rollup->mouseClicks += counterDelta(JournalFormat::readValue<qint32>(p + 8), lastClicks);
+    rollup->keystrokes += counterDelta(JournalFormat::readValue<qint32>(p + 12), lastKeystrokes);
+    rollup->wheelTicks += JournalFormat::readValue<qint32>(p + 40);
+    rollup->pointerDistance += distance;
+    if (distance > 0.0 && velocity > 0.0) {
+        rollup->movingSeconds += distance / velocity;
+        rollup->peakVelocity = qMax(rollup->peakVelocity, velocity);
+    }
+    const quint64 focus = (quint64(JournalFormat::readValue<quint32>(p + 16)) << 32) |
+                          JournalFormat::readValue<quint32>(p + 20);
+    rollup->dwell[focus] += 1;
+}
+
+// 分钟桶并入小时汇总，桶的主导窗口按停留整分钟计
+void addBucket(Rollup* rollup, const char* p)
+{
+    const double distance = JournalFormat::readDouble(p + 32);
+    const double meanVelocity = JournalFormat::readDouble(p + 48);
+    rollup->activeSeconds += JournalFormat::readValue<qint32>(p + 8);
+    rollup->mouseClicks += JournalFormat::readValue<qint32>(p + 12);
+    rollup->keystrokes += JournalFormat::readValue<qint32>(p + 16);
+    rollup->wheelTicks += JournalFormat::readValue<qint32>(p + 28);
+    rollup->pointerDistance += distance;
+    rollup->peakVelocity = qMax(rollup->peakVelocity, JournalFormat::readDouble(p + 40));
+    if (distance > 0.0 && meanVelocity > 0.0) {
+        rollup->movingSeconds += distance / meanVelocity;
+    }
+    const quint64 focus = (quint64(JournalFormat::readValue<quint32>(p + 20)) << 32) |
+                          JournalFormat::readValue<quint32>(p + 24);
+    rollup->dwell[focus] += 60;
+}
+
+void mergeRollup(Rollup* into, const Rollup& from)
+{
+    into->activeSeconds += from.activeSeconds;
+    into->mouseClicks += from.mouseClicks;
+    into->keystrokes += from.keystrokes;
+    into->wheelTicks += from.wheelTicks;
+    into->pointerDistance += from.pointerDistance;
+    into->peakVelocity = qMax(into->peakVelocity, from.peakVelocity);
+    into->movingSeconds += from.movingSeconds;
+    for (auto it = from.dwell.constBegin(); it != from.dwell.constEnd(); ++it) {
+        into->dwell[it.key()] += it.value();
+    }
+    for (int i = 0; i < LogHistogram::BucketCount; ++i) {
+        into->keyIntervals[i] += from.keyIntervals[i];
+    }
+}
+
+void addKeyIntervals(Rollup* rollup, const char* p)
+{
+    for (int i = 0; i < LogHistogram::BucketCount; ++i) {
+        rollup->keyIntervals[i] += JournalFormat::readValue<quint16>(p + i * 2);
+    }
+}
+
+void appendRecord(QByteArray* out, JournalFormat::RecordType type, const char* payload)
+{
+    char header[JournalFormat::RecordHeaderSize] = {};
+    header[0] = static_cast<char>(type);
+    JournalFormat::writeValue<quint16>(header + 2, qChecksum(QByteArrayView(payload, JournalFormat::PayloadSize)));
+    out->append(header, JournalFormat::RecordHeaderSize);
+    out->append(payload, JournalFormat::PayloadSize);
+}
+
+void appendRollup(QByteArray* out, JournalFormat::RecordType type, const Rollup& rollup)
+{
+    quint64 dominant = 0;
+    qint64 longest = -1;
+    for (auto it = rollup.dwell.constBegin(); it != rollup.dwell.constEnd(); ++it) {
+        if (it.value() > longest) {
+            dominant = it.key();
+            longest = it.value();
+        }
+    }
+
+    char p[JournalFormat::PayloadSize] = {};
+    JournalFormat::writeValue<qint64>(p, rollup.startMs);
+    JournalFormat::writeValue<qint32>(p + 8, rollup.activeSeconds);
+    JournalFormat::writeValue<qint32>(p + 12, rollup.mouseClicks);
+    JournalFormat::writeValue<qint32>(p + 16, rollup.keystrokes);
+    JournalFormat::writeValue<quint32>(p + 20, static_cast<quint32>(dominant >> 32));
+    JournalFormat::writeValue<quint32>(p + 24, static_cast<quint32>(dominant));
+    JournalFormat::writeValue<qint32>(p + 28, rollup.wheelTicks);
+    JournalFormat::writeDouble(p + 32, rollup.pointerDistance);
+    JournalFormat::writeDouble(p + 40, rollup.peakVelocity);
+    JournalFormat::writeDouble(p + 48, rollup.movingSeconds > 0.0 ? rollup.pointerDistance / rollup.movingSeconds : 0.0);
+    appendRecord(out, type, p);
+
+    bool hasKeyIntervals = false;
+    char k[JournalFormat::PayloadSize] = {};
+    for (int i = 0; i < LogHistogram::BucketCount; ++i) {
+        hasKeyIntervals = hasKeyIntervals || rollup.keyIntervals[i] > 0;
+        JournalFormat::writeValue<quint16>(k + i * 2, static_cast<quint16>(qMin<quint32>(rollup.keyIntervals[i], 0xffff)));
+    }
+    if (hasKeyIntervals) {
+        appendRecord(out, JournalFormat::RecordKeyIntervals, k);
+    }
+}
+
+// 映射整个文件；映射失败时退回读取到内存
+QByteArray mapFile(QFile& file)
+{
+    const qint64 size = file.size();
+    if (size <= 0) {
+        return QByteArray();
+    }
+    if (uchar* mapped = file.map(0, size)) {
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size);
+    }
+    return file.readAll();
+}
+
+} // namespace
+
+ActivityJournal::ActivityJournal(const QString& directory)
+    : m_directory(directory)
+    , m_dictionaryPath(QDir(directory).filePath(kDictionaryFileName))
+    , m_manifestPath(QDir(directory).filePath(kManifestFileName))
+    , m_storageWriter(nullptr)
+    , m_dictionaryBytes(0)
+    , m_manifestDirty(false)
+{
+}
+
+QString ActivityJournal::pathForDataFile(const QString& dataFilePath)
+{
+    const QFileInfo info(dataFilePath);
+    return info.dir().filePath(info.completeBaseName() + ".journal");
+}
+
+void ActivityJournal::remove(const QString& directory)
+{
+    // 只删除日志自己的文件，目录中的其他文件原样保留
+    QDir dir(directory);
+    const QStringList segments = dir.entryList({QString("*") + kSegmentSuffix}, QDir::Files);
+    for (const QString& segment : segments) {
+        dir.remove(segment);
+    }
+    dir.remove(kDictionaryFileName);
+    dir.remove(kManifestFileName);
+    QDir().rmdir(directory);
+}
+
+QDate ActivityJournal::dayOf(qint64 timestampMs)
+{
+    return QDateTime::fromMSecsSinceEpoch(timestampMs).date();
+}
+
+bool ActivityJournal::exists() const
+{
+    return QFileInfo::exists(m_directory) || QFileInfo::exists(m_directory + ".importing");
+}
+
+bool ActivityJournal::open()
+{
+    // 之前交给写入器的追加落盘后直接按段文件恢复
+    if (m_storageWriter) {
+        m_storageWriter->waitForDone();
+    }
+    m_inFlight.clear();
+    m_pendingDictionary.clear();
+    m_pendingRecords.clear();
+    m_manifest.clear();
+    m_tornFiles.clear();
+    m_dictionary = Dictionary();
+
+    // 旧版单文件日志占用了目录的路径：先改名，拆分导入成功后再改为 .migrated。
+    // 导入中途退出时 .importing 仍在，下次启动时重新导入
+    const QString importingPath = m_directory + ".importing";
+    if (QFileInfo(m_directory).isFile()) {
+        QFile::remove(importingPath);
+        if (!QFile::rename(m_directory, importingPath)) {
+            Logger::error(QString("无法迁移旧版活动日志: %1").arg(m_directory), "ActivityJournal");
+            return false;
+        }
+    }
+    if (QFile::exists(importingPath) && !importLegacyFile(importingPath)) {
+        return false;
+    }
+
+    if (!readDictionary(m_dictionaryPath, &m_dictionary)) {
+        return false;
+    }
+    m_dictionaryBytes = QFileInfo(m_dictionaryPath).size();
+    loadManifest();
+
+    // 清单是定期保存的快照，段在每次提交时追加：大小不符的段按段文件恢复
+    QDir dir(m_directory);
+    QSet<QDate> segmentDays;
+    const QFileInfoList segments = dir.entryInfoList({QString("*") + kSegmentSuffix}, QDir::Files);
+    for (const QFileInfo& segment : segments) {
+        const QDate date = QDate::fromString(segment.completeBaseName(), Qt::ISODate);
+        if (!date.isValid()) {
+            continue;
+        }
+        segmentDays.insert(date);
+        auto it = m_manifest.constFind(date);
+        if (it == m_manifest.constEnd() || it->bytes != segment.size()) {
+            recoverDay(date, segment.size());
+        }
+    }
+    for (auto it = m_manifest.begin(); it != m_manifest.end();) {
+        if (!segmentDays.contains(it.key())) {
+            it = m_manifest.erase(it);
+            m_manifestDirty = true;
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+bool ActivityJournal::importLegacyFile(const QString& filePath)
+{
+    const QFileInfo legacy(m_directory);
+    const QString dictionaryPath = legacy.dir().filePath(legacy.completeBaseName() + ".dict");
+
+    // 目录中已有段说明上次导入已完成、只是改名没有成功：不再重复导入
+    if (!hasSegments(m_directory)) {
+        Contents contents;
+        if (!readLegacyFile(filePath, dictionaryPath, &contents) || !create(m_directory, contents)) {
+            Logger::error("旧版活动日志导入失败，下次启动时重试", "ActivityJournal");
+            return false;
+        }
+        Logger::info(QString("旧版活动日志已按日期拆分到 %1").arg(m_directory), "ActivityJournal");
+    }
+
+    QFile::remove(m_directory + ".migrated");
+    if (!QFile::rename(filePath, m_directory + ".migrated")) {
+        Logger::warning(QString("无法将 %1 改名，文件保留但不会再次导入").arg(filePath), "ActivityJournal");
+    }
+    QFile::remove(dictionaryPath + ".migrated");
+    QFile::rename(dictionaryPath, dictionaryPath + ".migrated");
+    return true;
+}
+
+bool ActivityJournal::readLegacyFile(const QString& filePath, const QString& dictionaryPath, Contents* contents)
+{
+    Dictionary legacyDictionary;
+    if (!readDictionary(dictionaryPath, &legacyDictionary)) {
+        return false;
+    }
+    return readSegment(filePath, legacyDictionary, contents) >= 0;
+}
+
+bool ActivityJournal::hasSegments(const QString& directory)
+{
+    return !QDir(directory).entryList({QString("*") + kSegmentSuffix}, QDir::Files).isEmpty();
+}
+
+bool ActivityJournal::create(const QString& directory, const Contents& contents)
+{
+    if (hasSegments(directory) || QFileInfo(directory).isFile()) {
+        return false;
+    }
+
+    // 临时目录里只有这次要导入的数据，上次中途退出留下的可以直接清掉
+    const QString stagingPath = directory + ".staging";
+    remove(stagingPath);
+    {
+        ActivityJournal staging(stagingPath);
+        if (!staging.open()) {
+            return false;
+        }
+        staging.appendContents(contents);
+        staging.flush();
+        if (staging.hasPendingData()) {
+            remove(stagingPath);
+            return false;
+        }
+    }
+
+    // 目标目录中没有段，剩下的字典和清单没有数据可丢
+    remove(directory);
+    if (!QDir().rename(stagingPath, directory)) {
+        Logger::error(QString("无法将 %1 改名为 %2").arg(stagingPath, directory), "ActivityJournal");
+        remove(stagingPath);
+        return false;
+    }
+    return true;
+}
+
+void ActivityJournal::appendContents(const Contents& contents)
+{
+    // 读出的 ID 已映射到驻留池，重新追加时分配新字典中的 ID
+    for (const auto& data : contents.activities) {
+        append(data);
+    }
+    for (const auto& bucket : contents.buckets) {
+        append(bucket);
+    }
+    for (const auto& interval : contents.focusIntervals) {
+        append(interval);
+    }
+    for (const auto& interval : contents.breaks) {
+        append(interval);
+    }
+    for (const auto& event : contents.healthEvents) {
+        append(event);
+    }
+}
+
+bool ActivityJournal::loadDay(const QDate& date, Contents* contents)
+{
+    if (!m_manifest.contains(date)) {
+        return true;
+    }
+
+    // 已提交给写入器的追加须先落盘并取回结果，否则会漏读或与待提交的记录重复
+    if (m_storageWriter) {
+        m_storageWriter->waitForDone();
+        collectAppends();
+    }
+    if (readSegment(segmentPath(date), m_dictionary, contents) < 0) {
+        return false;
+    }
+
+    const QByteArray pending = m_pendingRecords.value(date);
+    parseRecords(pending.constData(), pending.size() / RecordSize, m_dictionary, contents);
+    return true;
+}
+
+void ActivityJournal::recoverDay(const QDate& date, qint64 segmentSize)
+{
+    // 段只比快照多出整条记录时只重放多出的尾部；段比快照短（快照先于追加落盘）或快照缺失时整段重新统计
+    DaySummary summary = m_manifest.value(date);
+    const bool replayTail = summary.bytes >= HeaderSize && summary.bytes < segmentSize &&
+                            (summary.bytes - HeaderSize) % RecordSize == 0;
+    if (!replayTail) {
+        const Tier tier = summary.tier;
+        summary = DaySummary();
+        summary.tier = tier;
+    }
+
+    Contents contents;
+    const qint64 size = readSegment(segmentPath(date), m_dictionary, &contents, summary.bytes);
+    m_manifestDirty = true;
+    if (size <= 0) {
+        m_manifest.remove(date);
+        return;
+    }
+
+    const DaySummary replayed = summarize(contents);
+    addSummary(&summary, replayed);
+    summary.bytes = size;
+    m_manifest.insert(date, summary);
+    Logger::info(QString("已从段文件恢复 %1 的 %2 条记录%3").arg(date.toString(Qt::ISODate)).arg(replayed.records)
+                     .arg(replayTail ? "" : "（整段重新统计）"), "ActivityJournal");
+}
+
+qint64 ActivityJournal::readSegment(const QString& path, const Dictionary& dictionary, Contents* contents,
+                                    qint64 fromBytes)
+{
+    QFile file(path);
+    if (!file.exists()) {
+        return 0;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::warning(QString("无法读取活动日志: %1").arg(path), "ActivityJournal");
+        return -1;
+    }
+
+    const QByteArray data = mapFile(file);
+    if (data.isEmpty()) {
+        return 0;
+    }
+    if (!isRecordFileHeader(data)) {
+        file.close();
+        moveAside(path);
+        return 0;
+    }
+
+    const qint64 recordCount = (data.size() - HeaderSize) / RecordSize;
+    const qint64 validSize = HeaderSize + recordCount * RecordSize;
+    const qint64 fileSize = data.size();
+    const qint64 skipped = qBound<qint64>(0, (fromBytes - HeaderSize) / RecordSize, recordCount);
+    parseRecords(data.constData() + HeaderSize + skipped * RecordSize, recordCount - skipped, dictionary, contents);
+    file.close();
+
+    if (fileSize != validSize) {
+        // 不完整的尾部会让之后追加的记录错位
+        QFile::resize(path, validSize);
+        Logger::warning(QString("活动日志 %1 尾部不完整（%2 字节），已截断").arg(path).arg(fileSize - validSize),
+                        "ActivityJournal");
+    }
+    return validSize;
+}
+
+void ActivityJournal::parseRecords(const char* data, qint64 count, const Dictionary& dictionary, Contents* contents)
+{
+    int corrupted = 0;
+    bool previousWasBucket = false;
+
+    // 只驻留读出的记录引用到的字符串，同一次读取中每个文件内 ID 只驻留一次
+    QHash<quint32, quint32> titleIds;
+    QHash<quint32, quint32> applicationIds;
+    auto poolId = [](QHash<quint32, quint32>* ids, const QHash<quint32, QString>& strings, StringInternPool& pool,
+                     quint32 fileId) -> quint32 {
+        if (fileId == 0) {
+            return StringInternPool::EmptyId;
+        }
+        auto it = ids->constFind(fileId);
+        if (it == ids->constEnd()) {
+            it = ids->insert(fileId, pool.intern(strings.value(fileId)));
+        }
+        return it.value();
+    };
+    auto titleId = [&](const char* field) {
+        return poolId(&titleIds, dictionary.titles, StringInternPool::titles(), readValue<quint32>(field));
+    };
+    auto applicationId = [&](const char* field) {
+        return poolId(&applicationIds, dictionary.applications, StringInternPool::applications(),
+                      readValue<quint32>(field));
+    };
+
+    for (qint64 i = 0; i < count; ++i) {
+        const char* record = data + i * RecordSize;
+        const char* p = record + RecordHeaderSize;
+        if (readValue<quint16>(record + 2) != qChecksum(QByteArrayView(p, PayloadSize))) {
+            corrupted++;
+            previousWasBucket = false;
+            continue;
+        }
+
+        const auto type = static_cast<quint8>(record[0]);
+        switch (type) {
+        case RecordActivity: {
+            ActivityMonitor::ActivityData activity;
+            activity.timestamp = QDateTime::fromMSecsSinceEpoch(readValue<qint64>(p));
+            activity.mouseClicks = readValue<qint32>(p + 8);
+            activity.keystrokes = readValue<qint32>(p + 12);
+            activity.windowTitleId = titleId(p + 16);
+            activity.applicationId = applicationId(p + 20);
+            activity.pointerDistance = readDouble(p + 24);
+            activity.pointerVelocity = readDouble(p + 32);
+            activity.wheelTicks = readValue<qint32>(p + 40);
+            activity.isActive = p[44] != 0;
+            contents->activities.append(activity);
+            break;
+        }
+        case RecordBucket:
+        case RecordHourBucket: {
+            ActivityMonitor::ActivityBucket bucket;
+            bucket.minuteStartMs = readValue<qint64>(p);
+            bucket.activeSeconds = readValue<qint32>(p + 8);
+            bucket.mouseClicks = readValue<qint32>(p + 12);
+            bucket.keystrokes = readValue<qint32>(p + 16);
+            bucket.dominantWindowTitleId = titleId(p + 20);
+            bucket.dominantApplicationId = applicationId(p + 24);
+            bucket.wheelTicks = readValue<qint32>(p + 28);
+            bucket.pointerDistance = readDouble(p + 32);
+            bucket.peakVelocity = readDouble(p + 40);
+            bucket.meanVelocity = readDouble(p + 48);
+            contents->buckets.append(bucket);
+            break;
+        }
+        case RecordKeyIntervals:
+            if (previousWasBucket) {
+                LogHistogram& histogram = contents->buckets.last().keyIntervals;
+                for (int bucket = 0; bucket < LogHistogram::BucketCount; ++bucket) {
+                    histogram.setCount(bucket, readValue<quint16>(p + bucket * 2));
+                }
+            }
+            break;
+        case RecordFocus: {
+            ActivityMonitor::FocusInterval interval;
+            interval.startMs = readValue<qint64>(p);
+            interval.endMs = readValue<qint64>(p + 8);
+            interval.applicationId = applicationId(p + 16);
+            interval.windowTitleId = titleId(p + 20);
+            interval.activeSeconds = readValue<qint32>(p + 24);
+            interval.mouseClicks = readValue<qint32>(p + 28);
+            interval.keystrokes = readValue<qint32>(p + 32);
+            contents->focusIntervals.append(interval);
+            break;
+        }
+        case RecordBreak: {
+            ActivityMonitor::BreakInterval interval;
+            interval.startMs = readValue<qint64>(p);
+            interval.endMs = readValue<qint64>(p + 8);
+            interval.sittingMs = readValue<qint64>(p + 16);
+            contents->breaks.append(interval);
+            break;
+        }
+        case RecordHealthEvent: {
+            HealthEvent event;
+            event.timestampMs = readValue<qint64>(p);
+            event.type = static_cast<HealthEngine::ReminderType>(readValue<qint32>(p + 8));
+            event.action = dictionary.actions.value(readValue<quint32>(p + 12));
+            contents->healthEvents.append(event);
+            break;
+        }
+        default:
+            // 新版本追加的记录类型：旧版本跳过即可
+            break;
+        }
+        previousWasBucket = type == RecordBucket || type == RecordHourBucket;
+    }
+
+    if (corrupted > 0) {
+        Logger::warning(QString("活动日志中有 %1 条记录校验失败，已跳过").arg(corrupted), "ActivityJournal");
+    }
+}
+
+bool ActivityJournal::readDictionary(const QString& path, Dictionary* dictionary)
+{
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::warning(QString("无法读取日志字典: %1").arg(path), "ActivityJournal");
+        return false;
+    }
+
+    const QByteArray data = mapFile(file);
+    if (data.isEmpty()) {
+        return true;
+    }
+    if (!isDictionaryFileHeader(data)) {
+        file.close();
+        moveAside(path);
+        return true;
+    }
+
+    qsizetype pos = HeaderSize;
+    while (pos + DictionaryEntryHeaderSize <= data.size()) {
+        const char* entry = data.constData() + pos;
+        const quint16 length = readValue<quint16>(entry + 5);
+        if (pos + DictionaryEntryHeaderSize + length > data.size()) {
+            break;
+        }
+        const auto kind = static_cast<quint8>(entry[0]);
+        const quint32 fileId = readValue<quint32>(entry + 1);
+        const QString value = QString::fromUtf8(entry + DictionaryEntryHeaderSize, length);
+        pos += DictionaryEntryHeaderSize + length;
+
+        if (kind == DictionaryTitle) {
+            dictionary->titles.insert(fileId, value);
+            dictionary->titleFileIds.insert(value, fileId);
+        } else if (kind == DictionaryApplication) {
+            dictionary->applications.insert(fileId, value);
+            dictionary->applicationFileIds.insert(value, fileId);
+        } else if (kind == DictionaryAction) {
+            dictionary->actions.insert(fileId, value);
+            dictionary->actionFileIds.insert(value, fileId);
+        }
+        dictionary->nextFileId = qMax(dictionary->nextFileId, fileId + 1);
+    }
+
+    const qint64 fileSize = data.size();
+    file.close();
+    if (pos != fileSize) {
+        QFile::resize(path, pos);
+        Logger::warning("日志字典尾部不完整，已截断", "ActivityJournal");
+    }
+    return true;
+}
+
+void ActivityJournal::loadManifest()
+{
+    QFile file(m_manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != kManifestVersion) {
+        return; // 段文件会被全部重新扫描
+    }
+
+    const QJsonObject days = root["days"].toObject();
+    for (auto it = days.begin(); it != days.end(); ++it) {
+        const QDate date = QDate::fromString(it.key(), Qt::ISODate);
+        if (!date.isValid()) {
+            continue;
+        }
+        const QJsonObject obj = it.value().toObject();
+        DaySummary summary;
+        summary.tier = static_cast<Tier>(qBound(0, obj["tier"].toInt(), static_cast<int>(Tier::Hourly)));
+        summary.bytes = obj["bytes"].toInteger();
+        summary.records = obj["records"].toInt();
+        summary.buckets = obj["buckets"].toInt();
+        summary.activeSeconds = obj["activeSeconds"].toInt();
+        summary.activeSamples = obj["activeSamples"].toInt();
+        summary.mouseClicks = obj["mouseClicks"].toInt();
+        summary.keystrokes = obj["keystrokes"].toInt();
+        summary.breaks = obj["breaks"].toInt();
+        summary.longestSittingMs = obj["longestSittingMs"].toInteger();
+        summary.healthEvents = obj["healthEvents"].toInt();
+        m_manifest.insert(date, summary);
+    }
+}
+
+void ActivityJournal::saveManifest()
+{
+    QJsonObject days;
+    for (auto it = m_manifest.constBegin(); it != m_manifest.constEnd(); ++it) {
+        const DaySummary& summary = it.value();
+        QJsonObject obj;
+        obj["segment"] = it.key().toString(Qt::ISODate) + kSegmentSuffix;
+        obj["tier"] = static_cast<int>(summary.tier);
+        obj["bytes"] = summary.bytes;
+        obj["records"] = summary.records;
+        obj["buckets"] = summary.buckets;
+        obj["activeSeconds"] = summary.activeSeconds;
+        obj["activeSamples"] = summary.activeSamples;
+        obj["mouseClicks"] = summary.mouseClicks;
+        obj["keystrokes"] = summary.keystrokes;
+        obj["breaks"] = summary.breaks;
+        obj["longestSittingMs"] = summary.longestSittingMs;
+        obj["healthEvents"] = summary.healthEvents;
+        days[it.key().toString(Qt::ISODate)] = obj;
+    }
+
+    QJsonObject root;
+    root["version"] = kManifestVersion;
+    root["days"] = days;
+    const QByteArray data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    if (m_storageWriter) {
+        m_manifestWrite = m_storageWriter->write(m_manifestPath, data);
+        m_manifestDirty = false;
+    } else {
+        m_manifestDirty = !StorageWriter::writeFile(m_manifestPath, data);
+    }
+}
+
+ActivityJournal::DaySummary ActivityJournal::summarize(const Contents& contents)
+{
+    DaySummary summary;
+    summary.records = contents.activities.size() + contents.buckets.size() + contents.focusIntervals.size() +
+                      contents.breaks.size() + contents.healthEvents.size();
+    for (const auto& data : contents.activities) {
+        summary.activeSamples += data.isActive ? 1 : 0;
+    }
+    for (const auto& bucket : contents.buckets) {
+        summary.buckets++;
+        summary.activeSeconds += bucket.activeSeconds;
+        summary.mouseClicks += bucket.mouseClicks;
+        summary.keystrokes += bucket.keystrokes;
+    }
+    for (const auto& interval : contents.breaks) {
+        summary.breaks++;
+        summary.longestSittingMs = qMax(summary.longestSittingMs, interval.sittingMs);
+    }
+    summary.healthEvents = contents.healthEvents.size();
+    return summary;
+}
+
+void ActivityJournal::append(const ActivityMonitor::ActivityData& data)
+{
+    const QDate date = data.timestamp.date();
+    if (!date.isValid()) {
+        return;
+    }
+    const quint32 titleId = dictionaryId(DictionaryTitle, data.windowTitleId);
+    const quint32 applicationId = dictionaryId(DictionaryApplication, data.applicationId);
+
+    char* p = beginRecord(date, RecordActivity);
+    writeValue<qint64>(p, data.timestamp.toMSecsSinceEpoch());
+    writeValue<qint32>(p + 8, data.mouseClicks);
+    writeValue<qint32>(p + 12, data.keystrokes);
+    writeValue<quint32>(p + 16, titleId);
+    writeValue<quint32>(p + 20, applicationId);
+    writeDouble(p + 24, data.pointerDistance);
+    writeDouble(p + 32, data.pointerVelocity);
+    writeValue<qint32>(p + 40, data.wheelTicks);
+    p[44] = data.isActive ? 1 : 0;
+    finishRecord(p);
+
+    DaySummary& summary = m_manifest[date];
+    summary.records++;
+    summary.activeSamples += data.isActive ? 1 : 0;
+}
+
+void ActivityJournal::append(const ActivityMonitor::ActivityBucket& bucket)
+{
+    const QDate date = dayOf(bucket.minuteStartMs);
+    const quint32 titleId = dictionaryId(DictionaryTitle, bucket.dominantWindowTitleId);
+    const quint32 applicationId = dictionaryId(DictionaryApplication, bucket.dominantApplicationId);
+
+    char* p = beginRecord(date, RecordBucket);
+    writeValue<qint64>(p, bucket.minuteStartMs);
+    writeValue<qint32>(p + 8, bucket.activeSeconds);
+    writeValue<qint32>(p + 12, bucket.mouseClicks);
+    writeValue<qint32>(p + 16, bucket.keystrokes);
+    writeValue<quint32>(p + 20, titleId);
+    writeValue<quint32>(p + 24, applicationId);
+    writeValue<qint32>(p + 28, bucket.wheelTicks);
+    writeDouble(p + 32, bucket.pointerDistance);
+    writeDouble(p + 40, bucket.peakVelocity);
+    writeDouble(p + 48, bucket.meanVelocity);
+    finishRecord(p);
+
+    // 大多数分钟没有按键，分布为空时不写
+    if (!bucket.keyIntervals.isEmpty()) {
+        p = beginRecord(date, RecordKeyIntervals);
+        for (int i = 0; i < LogHistogram::BucketCount; ++i) {
+            writeValue<quint16>(p + i * 2, static_cast<quint16>(qMin<quint32>(bucket.keyIntervals.count(i), 0xffff)));
+        }
+        finishRecord(p);
+    }
+
+    DaySummary& summary = m_manifest[date];
+    summary.records++;
+    summary.buckets++;
+    summary.activeSeconds += bucket.activeSeconds;
+    summary.mouseClicks += bucket.mouseClicks;
+    summary.keystrokes += bucket.keystrokes;
+}
+
+void ActivityJournal::append(const ActivityMonitor::FocusInterval& interval)
+{
+    const QDate date = dayOf(interval.startMs);
+    const quint32 applicationId = dictionaryId(DictionaryApplication, interval.applicationId);
+    const quint32 titleId = dictionaryId(DictionaryTitle, interval.windowTitleId);
+
+    char* p = beginRecord(date, RecordFocus);
+    writeValue<qint64>(p, interval.startMs);
+    writeValue<qint64>(p + 8, interval.endMs);
+    writeValue<quint32>(p + 16, applicationId);
+    writeValue<quint32>(p + 20, titleId);
+    writeValue<qint32>(p + 24, interval.activeSeconds);
+    writeValue<qint32>(p + 28, interval.mouseClicks);
+    writeValue<qint32>(p + 32, interval.keystrokes);
+    finishRecord(p);
+
+    m_manifest[date].records++;
+}
+
+void ActivityJournal::append(const ActivityMonitor::BreakInterval& interval)
+{
+    const QDate date = dayOf(interval.startMs);
+
+    char* p = beginRecord(date, RecordBreak);
+    writeValue<qint64>(p, interval.startMs);
+    writeValue<qint64>(p + 8, interval.endMs);
+    writeValue<qint64>(p + 16, interval.sittingMs);
+    finishRecord(p);
+
+    DaySummary& summary = m_manifest[date];
+    summary.records++;
+    summary.breaks++;
+    summary.longestSittingMs = qMax(summary.longestSittingMs, interval.sittingMs);
+}
+
+void ActivityJournal::append(const HealthEvent& event)
+{
+    const QDate date = dayOf(event.timestampMs);
+    const quint32 action = actionId(event.action);
+
+    char* p = beginRecord(date, RecordHealthEvent);
+    writeValue<qint64>(p, event.timestampMs);
+    writeValue<qint32>(p + 8, static_cast<qint32>(event.type));
+    writeValue<quint32>(p + 12, action);
+    finishRecord(p);
+
+    DaySummary& summary = m_manifest[date];
+    summary.records++;
+    summary.healthEvents++;
+}
+
+ActivityJournal::Compaction ActivityJournal::compactSegment(const QString& path, Tier target)
+{
+    Compaction compaction;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return compaction;
+    }
+    const QByteArray data = mapFile(file);
+    if (!isRecordFileHeader(data)) {
+        return compaction;
+    }
+    compaction.sourceSize = data.size();
+
+    // 保留的记录原样复制；逐秒记录并入分钟汇总，小时层的分钟桶并入小时汇总
+    QByteArray out = recordFileHeader();
+    QMap<qint64, Rollup> minutes;        // 分钟起点 -> 由逐秒记录补出的分钟
+    QSet<qint64> bucketMinutes;          // 已有分钟桶的分钟
+    QMap<qint64, Rollup> hours;          // 整点 -> 小时汇总
+    qint32 lastClicks = -1;
+    qint32 lastKeystrokes = -1;
+    Rollup* keyIntervalsTarget = nullptr; // 紧随的 KeyIntervals 并入的小时汇总
+    bool copyKeyIntervals = false;        // 紧随的 KeyIntervals 属于原样复制的桶
+
+    const qint64 count = (data.size() - HeaderSize) / RecordSize;
+    for (qint64 i = 0; i < count; ++i) {
+        const char* record = data.constData() + HeaderSize + i * RecordSize;
+        const char* p = record + RecordHeaderSize;
+        Rollup* nextKeyIntervalsTarget = nullptr;
+        bool nextCopyKeyIntervals = false;
+        if (readValue<quint16>(record + 2) != qChecksum(QByteArrayView(p, PayloadSize))) {
+            keyIntervalsTarget = nullptr;
+            copyKeyIntervals = false;
+            continue;
+        }
+
+        switch (static_cast<quint8>(record[0])) {
+        case RecordActivity:
+            if (target == Tier::Raw) {
+                out.append(record, RecordSize);
+            } else {
+                const qint64 timestampMs = readValue<qint64>(p);
+                const qint64 minuteStartMs = timestampMs - (timestampMs % kMinuteMs);
+                Rollup& minute = minutes[minuteStartMs];
+                minute.startMs = minuteStartMs;
+                addActivity(&minute, p, &lastClicks, &lastKeystrokes);
+            }
+            break;
+        case RecordBucket:
+            bucketMinutes.insert(readValue<qint64>(p));
+            if (target == Tier::Hourly) {
+                const qint64 hourStartMs = localHourStart(readValue<qint64>(p));
+                Rollup& hour = hours[hourStartMs];
+                hour.startMs = hourStartMs;
+                addBucket(&hour, p);
+                nextKeyIntervalsTarget = &hour;
+            } else {
+                out.append(record, RecordSize);
+                nextCopyKeyIntervals = true;
+            }
+            break;
+        case RecordKeyIntervals:
+            if (copyKeyIntervals) {
+                out.append(record, RecordSize);
+            } else if (keyIntervalsTarget) {
+                addKeyIntervals(keyIntervalsTarget, p);
+            }
+            break;
+        case RecordFocus:
+            if (target != Tier::Hourly) {
+                out.append(record, RecordSize);
+            }
+            break;
+        case RecordHourBucket:
+            out.append(record, RecordSize);
+            nextCopyKeyIntervals = true;
+            break;
+        default:
+            // 休息、健康事件与无法识别的记录类型在各层级都保留
+            out.append(record, RecordSize);
+            break;
+        }
+        keyIntervalsTarget = nextKeyIntervalsTarget;
+        copyKeyIntervals = nextCopyKeyIntervals;
+    }
+    file.close();
+
+    // 没有分钟桶的分钟（如旧版只有逐秒记录的数据）由逐秒记录补出
+    for (auto it = minutes.constBegin(); it != minutes.constEnd(); ++it) {
+        if (bucketMinutes.contains(it.key())) {
+            continue;
+        }
+        if (target == Tier::Hourly) {
+            const qint64 hourStartMs = localHourStart(it.key());
+            Rollup& hour = hours[hourStartMs];
+            hour.startMs = hourStartMs;
+            mergeRollup(&hour, it.value());
+        } else {
+            appendRollup(&out, RecordBucket, it.value());
+        }
+    }
+    for (const Rollup& hour : hours) {
+        appendRollup(&out, RecordHourBucket, hour);
+    }
+
+    Contents contents;
+    parseRecords(out.constData() + HeaderSize, (out.size() - HeaderSize) / RecordSize, Dictionary(), &contents);
+    compaction.summary = summarize(contents);
+    compaction.summary.tier = target;
+    compaction.summary.bytes = out.size();
+    compaction.data = out;
+    return compaction;
+}
+
+bool ActivityJournal::applyCompaction(const QDate& date, const Compaction& compaction)
+{
+    // 压缩期间当天的段若有新的追加（已提交或尚未提交），结果已过时
+    if (m_storageWriter) {
+        m_storageWriter->waitForDone();
+        collectAppends();
+    }
+    const QString path = segmentPath(date);
+    if (compaction.sourceSize < 0 || !m_manifest.contains(date) || m_pendingRecords.contains(date) ||
+        QFileInfo(path).size() != compaction.sourceSize) {
+        return false;
+    }
+    if (!StorageWriter::writeFile(path, compaction.data)) {
+        return false;
+    }
+
+    // 段已整体替换，立即保存清单，避免下次启动按旧快照的偏移重放
+    m_manifest.insert(date, compaction.summary);
+    saveManifest();
+    Logger::info(QString("已将 %1 的活动日志段压缩到%2层级：%3 -> %4 字节")
+                     .arg(date.toString(Qt::ISODate), compaction.summary.tier == Tier::Hourly ? "小时" : "分钟")
+                     .arg(compaction.sourceSize).arg(compaction.data.size()), "ActivityJournal");
+    return true;
+}
+
+bool ActivityJournal::hasPendingData() const
+{
+    return !m_pendingRecords.isEmpty() || !m_pendingDictionary.isEmpty();
+}
+
+bool ActivityJournal::commit()
+{
+    bool ok = collectAppends();
+    if (!hasPendingData()) {
+        return ok;
+    }
+    if (!QDir().mkpath(m_directory)) {
+        Logger::warning(QString("无法创建日志目录: %1").arg(m_directory), "ActivityJournal");
+        return false;
+    }
+
+    // 字典在调用线程同步写入并落盘：记录引用的 ID 必须先有定义，
+    // 交给写入器时它与段的追加在不同线程进行，无法保证先于段落盘
+    if (!m_pendingDictionary.isEmpty()) {
+        if (!truncateTail(m_dictionaryPath, m_dictionaryBytes)) {
+            return false;
+        }
+        const QByteArray data = m_dictionaryBytes >= HeaderSize ? m_pendingDictionary
+                                                                : dictionaryFileHeader() + m_pendingDictionary;
+        if (!StorageWriter::appendFile(m_dictionaryPath, data)) {
+            m_tornFiles.insert(m_dictionaryPath);
+            truncateTail(m_dictionaryPath, m_dictionaryBytes);
+            return false;
+        }
+        m_dictionaryBytes += data.size();
+        m_pendingDictionary.clear();
+    }
+
+    for (auto it = m_pendingRecords.begin(); it != m_pendingRecords.end();) {
+        // 上一次追加确认之前不再追加当天的段，失败时才能截回确定的长度
+        if (m_inFlight.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        const QString path = segmentPath(it.key());
+        DaySummary& summary = m_manifest[it.key()];
+        if (!truncateTail(path, summary.bytes)) {
+            ok = false;
+            ++it;
+            continue;
+        }
+        const QByteArray data = summary.bytes > 0 ? it.value() : recordFileHeader() + it.value();
+        if (m_storageWriter) {
+            m_inFlight.insert(it.key(), {m_storageWriter->append(path, data), it.value().size(), data.size()});
+            ++it;
+            continue;
+        }
+        if (!StorageWriter::appendFile(path, data)) {
+            m_tornFiles.insert(path);
+            truncateTail(path, summary.bytes);
+            ok = false;
+            ++it;
+            continue;
+        }
+        summary.bytes += data.size();
+        m_manifestDirty = true;
+        it = m_pendingRecords.erase(it);
+    }
+    return ok;
+}
+
+bool ActivityJournal::collectAppends()
+{
+    // 清单快照没有写成时，下次保存重新写入
+    if (m_manifestWrite.isFinished() && m_manifestWrite.resultCount() > 0) {
+        if (!m_manifestWrite.result()) {
+            m_manifestDirty = true;
+        }
+        m_manifestWrite = QFuture<bool>();
+    }
+
+    // 落盘的记录移出待提交缓冲并计入段长度；失败的追加截回原长度，记录留到下次提交
+    bool ok = true;
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (!it->result.isFinished()) {
+            ++it;
+            continue;
+        }
+        const QDate date = it.key();
+        if (it->result.resultCount() > 0 && it->result.result()) {
+            m_manifest[date].bytes += it->bytes;
+            m_manifestDirty = true;
+            QByteArray& pending = m_pendingRecords[date];
+            pending.remove(0, it->records);
+            if (pending.isEmpty()) {
+                m_pendingRecords.remove(date);
+            }
+        } else {
+            const QString path = segmentPath(date);
+            m_tornFiles.insert(path);
+            truncateTail(path, m_manifest.value(date).bytes);
+            ok = false;
+        }
+        it = m_inFlight.erase(it);
+    }
+    return ok;
+}
+
+void ActivityJournal::flush()
+{
+    commit();
+    // 清单快照只记录已落盘的段长度，须等写入器确认
+    if (m_storageWriter) {
+        m_storageWriter->waitForDone();
+        collectAppends();
+    }
+    if (!hasPendingData() && m_manifestDirty) {
+        saveManifest();
+    }
+}
+
+QString ActivityJournal::segmentPath(const QDate& date) const
+{
+    return QDir(m_directory).filePath(date.toString(Qt::ISODate) + kSegmentSuffix);
+}
+
+bool ActivityJournal::truncateTail(const QString& path, qint64 size)
+{
+    // 追加失败后文件尾部可能留有部分数据，重新追加前截回已落盘的长度，否则之后的记录会错位
+    if (!m_tornFiles.contains(path)) {
+        return true;
+    }
+    if (QFile::exists(path) && !QFile::resize(path, size)) {
+        Logger::warning(QString("无法截断 %1 的不完整尾部").arg(path), "ActivityJournal");
+        return false;
+    }
+    m_tornFiles.remove(path);
+    return true;
+}
+
+char* ActivityJournal::beginRecord(const QDate& date, RecordType type)
+{
+    QByteArray& pending = m_pendingRecords[date];
+    const qsizetype offset = pending.size();
+    pending.append(RecordSize, '\0');
+    char* record = pending.data() + offset;
+    record[0] = static_cast<char>(type);
+    return record + RecordHeaderSize;
+}
+
+void ActivityJournal::finishRecord(char* payload)
+{
+    writeValue<quint16>(payload - RecordHeaderSize + 2, qChecksum(QByteArrayView(payload, PayloadSize)));
+}
+
+quint32 ActivityJournal::dictionaryId(DictionaryKind kind, quint32 poolId)
+{
+    if (poolId == StringInternPool::EmptyId) {
+        return 0;
+    }
+    const bool isTitle = kind == DictionaryTitle;
+    QHash<quint32, quint32>& poolIds = isTitle ? m_dictionary.titlePoolIds : m_dictionary.applicationPoolIds;
+    auto it = poolIds.constFind(poolId);
+    if (it != poolIds.constEnd()) {
+        return it.value();
+    }
+
+    // 池中回收后重新驻留的字符串换了新 ID，按字符串找回已有的字典项
+    const StringInternPool& pool = isTitle ? StringInternPool::titles() : StringInternPool::applications();
+    const QString value = pool.resolve(poolId);
+    if (value.isEmpty()) {
+        return 0;
+    }
+    QHash<QString, quint32>& fileIds = isTitle ? m_dictionary.titleFileIds : m_dictionary.applicationFileIds;
+    quint32 fileId = fileIds.value(value);
+    if (fileId == 0) {
+        fileId = m_dictionary.nextFileId++;
+        fileIds.insert(value, fileId);
+        (isTitle ? m_dictionary.titles : m_dictionary.applications).insert(fileId, value);
+        appendDictionaryEntry(kind, fileId, value);
+    }
+    if (poolIds.size() >= pool.capacity()) {
+        poolIds.clear();
+    }
+    poolIds.insert(poolId, fileId);
+    return fileId;
+}
+
+quint32 ActivityJournal::actionId(const QString& action)
+{
+    if (action.isEmpty()) {
+        return 0;
+    }
+    auto it = m_dictionary.actionFileIds.constFind(action);
+    if (it != m_dictionary.actionFileIds.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 fileId = m_dictionary.nextFileId++;
+    m_dictionary.actionFileIds.insert(action, fileId);
+    m_dictionary.actions.insert(fileId, action);
+    appendDictionaryEntry(DictionaryAction, fileId, action);
+    return fileId;
+}
+
+void ActivityJournal::appendDictionaryEntry(DictionaryKind kind, quint32 fileId, const QString& value)
+{
+    const QByteArray utf8 = value.toUtf8().left(MaxDictionaryValueSize);
+    char entry[DictionaryEntryHeaderSize];
+    entry[0] = static_cast<char>(kind);
+    writeValue<quint32>(entry + 1, fileId);
+    writeValue<quint16>(entry + 5, static_cast<quint16>(utf8.size()));
+    m_pendingDictionary.append(entry, DictionaryEntryHeaderSize);
+    m_pendingDictionary.append(utf8);
+}
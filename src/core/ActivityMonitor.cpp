@@ -1,237 +1,394 @@
 #include "core/ActivityMonitor.h"
+#include "core/ActivityCapture.h"
+#include "core/BreakDetector.h"
+#include "core/FocusTracker.h"
+#include "core/MinuteAggregator.h"
+#include "core/TraceRecorder.h"
 #include "utils/Logger.h"
-#include "utils/SystemUtils.h"
-#include <QApplication>
-#include <QDebug>
-
-#ifdef Q_OS_WIN
-#include <windows.h>
-#include <winuser.h>
-#elif defined(Q_OS_LINUX)
-#include <X11/Xlib.h>
-#include <X11/extensions/scrnsaver.h>
-#include <X11/Xutil.h>
-#elif defined(Q_OS_MACOS)
-#include <ApplicationServices/ApplicationServices.h>
-#endif
+#include "utils/MonotonicClock.h"
+#include "utils/StringInternPool.h"
+#include <QMetaMethod>
+#include <QThread>
+
+namespace {
+
+constexpr int kBatchSize = 64;
+constexpr int kBatchMaxAgeMs = 5000;
+
+} // namespace
 
 class ActivityMonitor::Private
 {
 public:
-#ifdef Q_OS_WIN
-    // Windows 平台相关数据
-    LASTINPUTINFO lastInputInfo;
-#elif defined(Q_OS_LINUX)
-    // Linux 平台相关数据
-    Display* display;
-    XScreenSaverInfo* screenSaverInfo;
-#endif
-    
+    // 采集线程写入、GUI 线程读取的无锁队列
+    ActivityCapture::SampleRing ring;
+
     int lastMouseClicks = 0;
     int lastKeystrokes = 0;
+    int lastMotionEvents = 0;
+    double lastPointerDistance = 0.0;
+    int lastWheelTicks = 0;
+    qint64 lastTimestampMs = 0;
+    LogHistogram lastKeyIntervals;
+
+    MinuteAggregator aggregator;
+    FocusTracker focusTracker;
+    BreakDetector breakDetector;
+
+    // 组批中的逐秒数据，发出后交给接收方共享，这里换成新的空批次
+    ActivityBatch batch;
 };
 
+QString ActivityMonitor::ActivityData::activeWindowTitle() const
+{
+    return StringInternPool::titles().resolve(windowTitleId);
+}
+
+QString ActivityMonitor::ActivityData::activeApplicationName() const
+{
+    return StringInternPool::applications().resolve(applicationId);
+}
+
 ActivityMonitor::ActivityMonitor(QObject *parent)
     : QObject(parent)
-    , m_timer(new QTimer(this))
-    , m_lastActivityTime(QDateTime::currentDateTime())
+    , m_captureThread(new QThread(this))
+    , m_batchTimer(new QTimer(this))
+    , m_capture(nullptr)
+    , m_traceRecorder(nullptr)
+    , m_highResolution(false)
+    , m_idleThresholdMs(30 * 1000)
+    , m_lastActivityMs(MonotonicClock::currentUnixMs())
     , m_sessionStartTime(QDateTime::currentDateTime())
     , m_isActive(false)
-    , m_todayActiveMinutes(0)
+    , m_todayActiveSeconds(0)
     , d(std::make_unique<Private>())
 {
-    m_timer->setInterval(1000); // 每秒检查一次
-    connect(m_timer, &QTimer::timeout, this, &ActivityMonitor::checkActivity);
-    
-    initializeSystemHooks();
+    m_captureThread->setObjectName("ActivityCapture");
+
+    m_batchTimer->setSingleShot(true);
+    m_batchTimer->setInterval(kBatchMaxAgeMs);
+    connect(m_batchTimer, &QTimer::timeout, this, &ActivityMonitor::flushBatch);
+
+    m_capture = new ActivityCapture(&d->ring);
+    m_capture->moveToThread(m_captureThread);
+
+    connect(m_captureThread, &QThread::started, m_capture, &ActivityCapture::initialize);
+    connect(m_captureThread, &QThread::finished, m_capture, &QObject::deleteLater);
+    connect(m_capture, &ActivityCapture::samplesAvailable,
+            this, &ActivityMonitor::drainSamples, Qt::QueuedConnection);
+    connect(m_capture, &ActivityCapture::idleStateChanged,
+            this, &ActivityMonitor::onIdleStateChanged, Qt::QueuedConnection);
+    connect(m_capture, &ActivityCapture::fullscreenChanged,
+            this, &ActivityMonitor::fullscreenChanged, Qt::QueuedConnection);
+    connect(m_capture, &ActivityCapture::screenLockChanged,
+            this, &ActivityMonitor::onScreenLockChanged, Qt::QueuedConnection);
 }
 
 ActivityMonitor::~ActivityMonitor()
 {
-    cleanupSystemHooks();
+    // 采集对象在线程结束时于采集线程内析构，此后才能释放环形缓冲区
+    if (m_captureThread->isRunning()) {
+        m_captureThread->quit();
+        m_captureThread->wait();
+    } else {
+        delete m_capture;
+    }
 }
 
 void ActivityMonitor::start()
 {
     Logger::info("开始监测用户活动");
     m_sessionStartTime = QDateTime::currentDateTime();
-    m_timer->start();
+
+    // 采集线程在首次启动时才创建，轨迹回放等场景不会连接显示服务
+    if (!m_captureThread->isRunning()) {
+        m_captureThread->start();
+    }
+    QMetaObject::invokeMethod(m_capture, &ActivityCapture::start, Qt::QueuedConnection);
 }
 
 void ActivityMonitor::stop()
 {
     Logger::info("停止监测用户活动");
-    m_timer->stop();
+    QMetaObject::invokeMethod(m_capture, &ActivityCapture::stop, Qt::QueuedConnection);
+    flushAggregation();
 }
 
-bool ActivityMonitor::isUserActive() const
+void ActivityMonitor::setHighResolutionMode(bool enabled)
 {
-    return m_isActive;
+    m_highResolution = enabled;
 }
 
-QDateTime ActivityMonitor::getLastActivityTime() const
+void ActivityMonitor::setDisplayName(const QString& displayName)
 {
-    return m_lastActivityTime;
+    if (m_captureThread->isRunning()) {
+        Logger::warning("采集线程已启动，无法更改显示", "ActivityMonitor");
+        return;
+    }
+    m_displayName = displayName;
+    m_capture->setDisplayName(displayName);
+    m_captureThread->setObjectName(displayName.isEmpty() ? QString("ActivityCapture")
+                                                         : QString("ActivityCapture %1").arg(displayName));
 }
 
-int ActivityMonitor::getTodayActiveMinutes() const
+void ActivityMonitor::setIdleThreshold(int thresholdMs)
 {
-    return m_todayActiveMinutes;
+    m_idleThresholdMs = thresholdMs;
+    ActivityCapture* capture = m_capture;
+    QMetaObject::invokeMethod(capture, [capture, thresholdMs]() {
+        capture->setIdleThreshold(thresholdMs);
+    }, Qt::QueuedConnection);
 }
 
-void ActivityMonitor::checkActivity()
+void ActivityMonitor::flushAggregation()
 {
-    ActivityData data;
-    data.timestamp = QDateTime::currentDateTime();
-    data.mouseClicks = getCurrentMouseClicks();
-    data.keystrokes = getCurrentKeystrokes();
-    data.activeWindow = getCurrentActiveWindow();
-    
-    // 检查是否有新的活动
-    bool hasNewActivity = (data.mouseClicks > d->lastMouseClicks) || 
-                         (data.keystrokes > d->lastKeystrokes);
-    
-    if (hasNewActivity) {
-        m_lastActivityTime = data.timestamp;
-        if (!m_isActive) {
-            m_isActive = true;
-            emit userBecameActive();
-        }
-        data.isActive = true;
-        emit activityDetected(data);
-    } else {
-        // 检查是否超过一定时间无活动（例如30秒）
-        if (m_isActive && m_lastActivityTime.secsTo(data.timestamp) > 30) {
-            m_isActive = false;
-            emit userBecameInactive();
-        }
-        data.isActive = m_isActive;
+    flushBatch();
+
+    ActivityBucket bucket;
+    if (d->aggregator.flush(&bucket)) {
+        emitBucket(bucket);
     }
-    
-    d->lastMouseClicks = data.mouseClicks;
-    d->lastKeystrokes = data.keystrokes;
-    
-    // 更新今日活跃时间
-    if (data.isActive) {
-        m_todayActiveMinutes++;
+    FocusInterval interval;
+    if (d->focusTracker.flush(&interval)) {
+        emit focusIntervalReady(interval);
+    }
+    BreakInterval breakInterval;
+    if (d->breakDetector.flush(&breakInterval)) {
+        emit breakDetected(breakInterval);
     }
 }
 
-void ActivityMonitor::initializeSystemHooks()
+void ActivityMonitor::appendToBatch(const ActivityData& data)
 {
-#ifdef Q_OS_WIN
-    d->lastInputInfo.cbSize = sizeof(LASTINPUTINFO);
-#elif defined(Q_OS_LINUX)
-    d->display = XOpenDisplay(nullptr);
-    if (d->display) {
-        d->screenSaverInfo = XScreenSaverAllocInfo();
+    if (d->batch.isEmpty()) {
+        d->batch.reserve(kBatchSize);
+        m_batchTimer->start();
+    }
+    d->batch.append(data);
+    if (d->batch.size() >= kBatchSize) {
+        flushBatch();
     }
-#endif
 }
 
-void ActivityMonitor::cleanupSystemHooks()
+void ActivityMonitor::flushBatch()
 {
-#ifdef Q_OS_LINUX
-    if (d->display) {
-        if (d->screenSaverInfo) {
-            XFree(d->screenSaverInfo);
-        }
-        XCloseDisplay(d->display);
+    if (d->batch.isEmpty()) {
+        return;
     }
-#endif
+    m_batchTimer->stop();
+
+    ActivityBatch batch;
+    batch.swap(d->batch);
+    emit activityBatchReady(batch);
 }
 
-int ActivityMonitor::getCurrentMouseClicks()
+void ActivityMonitor::emitBucket(const ActivityBucket& bucket)
 {
-#ifdef Q_OS_WIN
-    // Windows: 获取鼠标点击计数
-    static DWORD lastMouseClickTime = 0;
-    static int clickCount = 0;
-    
-    POINT cursorPos;
-    GetCursorPos(&cursorPos);
-    
-    DWORD currentTime = GetTickCount();
-    if (currentTime - lastMouseClickTime > 100) { // 100ms间隔检测
-        // 检查鼠标按键状态
-        if (GetAsyncKeyState(VK_LBUTTON) & 0x8000 || 
-            GetAsyncKeyState(VK_RBUTTON) & 0x8000 ||
-            GetAsyncKeyState(VK_MBUTTON) & 0x8000) {
-            clickCount++;
-            lastMouseClickTime = currentTime;
-        }
+    // 今日活跃时间只按分钟桶累计：采样间隔不是固定一秒，逐条计数会偏差
+    const QDate day = QDateTime::fromMSecsSinceEpoch(bucket.minuteStartMs).date();
+    if (day > m_todayDate) {
+        m_todayDate = day;
+        m_todayActiveSeconds = 0;
     }
-    return clickCount;
-#elif defined(Q_OS_LINUX)
-    // Linux: 使用X11获取鼠标状态
-    if (!d->display) return d->lastMouseClicks;
-    
-    Window root, child;
-    int root_x, root_y, win_x, win_y;
-    unsigned int mask;
-    
-    if (XQueryPointer(d->display, DefaultRootWindow(d->display),
-                     &root, &child, &root_x, &root_y, &win_x, &win_y, &mask)) {
-        static int lastClickCount = 0;
-        if (mask & (Button1Mask | Button2Mask | Button3Mask)) {
-            lastClickCount++;
-        }
-        return lastClickCount;
+    if (day == m_todayDate) {
+        m_todayActiveSeconds += bucket.activeSeconds;
     }
-    return d->lastMouseClicks;
-#else
-    // 其他平台或模拟数据
-    static int counter = 0;
-    return ++counter;
-#endif
+    emit activityBucketReady(bucket);
 }
 
-int ActivityMonitor::getCurrentKeystrokes()
+void ActivityMonitor::setBreakThresholds(qint64 minBreakMs, qint64 mergeGapMs)
 {
-#ifdef Q_OS_WIN
-    // Windows: 检测键盘活动
-    static int keystrokeCount = 0;
-    static DWORD lastKeystrokeTime = 0;
-    
-    DWORD currentTime = GetTickCount();
-    if (currentTime - lastKeystrokeTime > 50) { // 50ms间隔检测
-        // 检查常用按键状态
-        for (int key = 8; key <= 255; key++) {
-            if (GetAsyncKeyState(key) & 0x8000) {
-                keystrokeCount++;
-                lastKeystrokeTime = currentTime;
-                break;
-            }
+    d->breakDetector.setThresholds(minBreakMs, mergeGapMs);
+}
+
+void ActivityMonitor::setUserActive(bool active, qint64 timestampMs)
+{
+    if (active == m_isActive) {
+        return;
+    }
+    m_isActive = active;
+
+    if (active) {
+        d->breakDetector.userBecameActive(timestampMs);
+        emit userBecameActive();
+    } else {
+        // 离开从最后一次输入算起，而不是越过空闲阈值的时刻
+        BreakInterval breakInterval;
+        const bool finished = d->breakDetector.userBecameIdle(m_lastActivityMs, &breakInterval);
+        emit userBecameInactive();
+        if (finished) {
+            emit breakDetected(breakInterval);
         }
     }
-    return keystrokeCount;
-#elif defined(Q_OS_LINUX)
-    // Linux: 使用X11检测键盘活动
-    if (!d->display) return d->lastKeystrokes;
+}
+
+bool ActivityMonitor::isUserActive() const
+{
+    return m_isActive;
+}
+
+QDateTime ActivityMonitor::getLastActivityTime() const
+{
+    return QDateTime::fromMSecsSinceEpoch(m_lastActivityMs);
+}
+
+int ActivityMonitor::getTodayActiveMinutes() const
+{
+    return m_todayDate == QDate::currentDate() ? m_todayActiveSeconds / 60 : 0;
+}
+
+ActivityMonitor::CaptureStats ActivityMonitor::getCaptureStats() const
+{
+    CaptureStats stats;
+    stats.samplesCaptured = m_capture->samplesCaptured();
+    stats.overruns = m_capture->overruns();
+    stats.queueDepth = static_cast<int>(d->ring.size());
+    stats.maxQueueDepth = m_capture->maxQueueDepth();
+    stats.queueCapacity = static_cast<int>(ActivityCapture::SampleRing::capacity());
+    stats.samplingIntervalMs = m_capture->samplingIntervalMs();
+    stats.wakeupsSaved = m_capture->wakeupsSaved();
+    return stats;
+}
+
+bool ActivityMonitor::isFullscreenActive() const
+{
+    return m_capture->isFullscreenActive();
+}
+
+bool ActivityMonitor::isScreenLocked() const
+{
+    return m_capture->isScreenLocked();
+}
+
+void ActivityMonitor::setTraceRecorder(TraceRecorder* recorder)
+{
+    m_traceRecorder = recorder;
+}
+
+void ActivityMonitor::injectSample(const ActivityCapture::Sample& sample)
+{
+    processSample(sample);
+}
+
+void ActivityMonitor::drainSamples()
+{
+    // 先清除通知标记再取数据，取数期间新写入的采样会触发下一次投递
+    m_capture->acknowledgeSamples();
+
+    ActivityCapture::Sample sample;
+    while (d->ring.tryPop(sample)) {
+        processSample(sample);
+    }
+}
+
+void ActivityMonitor::onIdleStateChanged(bool idle)
+{
+    // 暂停采样前的最后一个采样已先于此通知入队，先处理完再切换状态
+    drainSamples();
+
+    if (!idle && !m_isActive) {
+        m_lastActivityMs = MonotonicClock::currentUnixMs();
+    }
+    // 锁屏期间的活跃报警来自锁屏界面上的输入，等解锁再恢复
+    if (!idle && m_capture->isScreenLocked()) {
+        return;
+    }
+    setUserActive(!idle, m_lastActivityMs);
+}
+
+void ActivityMonitor::onScreenLockChanged(bool locked)
+{
+    drainSamples();
+
+    if (locked) {
+        // 锁屏期间没有采样，先交出未满的批次；离开从最后一次输入算起
+        flushBatch();
+        setUserActive(false, m_lastActivityMs);
+    } else {
+        m_lastActivityMs = MonotonicClock::currentUnixMs();
+        setUserActive(true, m_lastActivityMs);
+    }
+    emit screenLockChanged(locked);
+}
+
+void ActivityMonitor::processSample(const ActivityCapture::Sample& sample)
+{
+    if (m_traceRecorder) {
+        m_traceRecorder->record(sample);
+    }
+
+    BreakInterval breakInterval;
+    if (d->breakDetector.update(sample.timestampMs, &breakInterval)) {
+        emit breakDetected(breakInterval);
+    }
+
+    ActivityData data;
+    data.mouseClicks = sample.mouseClicks;
+    data.keystrokes = sample.keystrokes;
+    data.windowTitleId = sample.windowTitleId;
+    data.applicationId = sample.applicationId;
+    data.pointerDistance = qMax(0.0, sample.pointerDistance - d->lastPointerDistance);
+    data.wheelTicks = qMax(0, sample.wheelTicks - d->lastWheelTicks);
+    if (d->lastTimestampMs > 0 && sample.timestampMs > d->lastTimestampMs) {
+        data.pointerVelocity = data.pointerDistance * 1000.0 / (sample.timestampMs - d->lastTimestampMs);
+    }
     
-    char keys[32];
-    XQueryKeymap(d->display, keys);
+    // 检查是否有新的活动，原始事件模式下鼠标移动同样视为活动
+    bool hasNewActivity = (data.mouseClicks > d->lastMouseClicks) || 
+                         (data.keystrokes > d->lastKeystrokes) ||
+                         (sample.motionEvents > d->lastMotionEvents) ||
+                         (data.wheelTicks > 0);
     
-    static int lastKeystrokeCount = 0;
-    int activeKeys = 0;
-    for (int i = 0; i < 32; i++) {
-        if (keys[i] != 0) {
-            activeKeys++;
+    if (hasNewActivity) {
+        m_lastActivityMs = sample.timestampMs;
+        setUserActive(true, sample.timestampMs);
+        data.isActive = true;
+        if (m_highResolution) {
+            // 只有逐秒数据需要 QDateTime，分钟聚合全程使用整数时间戳
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(sample.timestampMs);
+            emit activityDetected(data);
+
+            static const QMetaMethod batchSignal = QMetaMethod::fromSignal(&ActivityMonitor::activityBatchReady);
+            if (isSignalConnected(batchSignal)) {
+                appendToBatch(data);
+            }
+        }
+    } else {
+        // 后端不能主动通知空闲时，按采样检查是否超过空闲阈值
+        if (m_isActive && !m_capture->hasIdleNotifications() &&
+            sample.timestampMs - m_lastActivityMs > m_idleThresholdMs) {
+            setUserActive(false, sample.timestampMs);
         }
+        data.isActive = m_isActive;
     }
-    
-    if (activeKeys > 0) {
-        lastKeystrokeCount++;
+
+    // 后端重新打开后累计值从零开始，此时整个分布都是新增
+    const LogHistogram keyIntervals = sample.keyIntervals.total() >= d->lastKeyIntervals.total()
+        ? sample.keyIntervals.since(d->lastKeyIntervals)
+        : sample.keyIntervals;
+
+    ActivityBucket bucket;
+    if (d->aggregator.add(sample.timestampMs, data.isActive,
+                          data.mouseClicks - d->lastMouseClicks,
+                          data.keystrokes - d->lastKeystrokes,
+                          data.pointerDistance, data.wheelTicks, keyIntervals,
+                          data.windowTitleId, data.applicationId, &bucket)) {
+        emitBucket(bucket);
     }
-    return lastKeystrokeCount;
-#else
-    // 其他平台或模拟数据
-    static int counter = 0;
-    return ++counter;
-#endif
-}
 
-QString ActivityMonitor::getCurrentActiveWindow()
-{
-    return SystemUtils::getActiveWindowTitle();
-}
\ No newline at end of file
+    FocusInterval interval;
+    if (d->focusTracker.add(sample.timestampMs, data.isActive,
+                            data.mouseClicks - d->lastMouseClicks,
+                            data.keystrokes - d->lastKeystrokes,
+                            data.windowTitleId, data.applicationId, &interval)) {
+        emit focusIntervalReady(interval);
+    }
+    
+    d->lastMouseClicks = data.mouseClicks;
+    d->lastKeystrokes = data.keystrokes;
+    d->lastMotionEvents = sample.motionEvents;
+    d->lastPointerDistance = sample.pointerDistance;
+    d->lastWheelTicks = sample.wheelTicks;
+    d->lastTimestampMs = sample.timestampMs;
+    d->lastKeyIntervals = sample.keyIntervals;
+}
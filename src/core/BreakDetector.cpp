@@ -0,0 +1,100 @@
+#include "core/BreakDetector.h"
+
+namespace {
+
+constexpr qint64 kDefaultMinBreakMs = 5 * 60 * 1000;
+constexpr qint64 kDefaultMergeGapMs = 60 * 1000;
+
+} // namespace
+
+BreakDetector::BreakDetector()
+    : m_minBreakMs(kDefaultMinBreakMs)
+    , m_mergeGapMs(kDefaultMergeGapMs)
+    , m_idle(false)
+    , m_hasPending(false)
+    , m_sessionStartMs(0)
+    , m_idleStartMs(0)
+    , m_idleEndMs(0)
+    , m_lastUpdateMs(0)
+{
+}
+
+void BreakDetector::setThresholds(qint64 minBreakMs, qint64 mergeGapMs)
+{
+    m_minBreakMs = minBreakMs;
+    m_mergeGapMs = mergeGapMs;
+}
+
+bool BreakDetector::userBecameIdle(qint64 lastInputMs, ActivityMonitor::BreakInterval* completed)
+{
+    if (m_idle) {
+        return false;
+    }
+    m_idle = true;
+    if (m_sessionStartMs == 0) {
+        m_sessionStartMs = lastInputMs;
+    }
+
+    // 上一段离开刚结束不久：中间的短暂活动不打断休息
+    if (m_hasPending && lastInputMs - m_idleEndMs < m_mergeGapMs) {
+        m_hasPending = false;
+        return false;
+    }
+
+    const bool finished = m_hasPending && finishPending(completed);
+    m_idleStartMs = lastInputMs;
+    return finished;
+}
+
+void BreakDetector::userBecameActive(qint64 timestampMs)
+{
+    if (!m_idle) {
+        return;
+    }
+    m_idle = false;
+    m_idleEndMs = timestampMs;
+    m_hasPending = true;
+}
+
+bool BreakDetector::update(qint64 timestampMs, ActivityMonitor::BreakInterval* completed)
+{
+    const qint64 previousMs = m_lastUpdateMs;
+    m_lastUpdateMs = timestampMs;
+    if (m_sessionStartMs == 0) {
+        m_sessionStartMs = timestampMs;
+    }
+    if (m_idle) {
+        return false;
+    }
+
+    // 活跃状态下长时间没有采样（系统挂起、锁屏后直接断开会话），这段时间按离开处理
+    if (previousMs > 0 && timestampMs - previousMs >= m_minBreakMs) {
+        const bool finished = userBecameIdle(previousMs, completed);
+        userBecameActive(timestampMs);
+        return finished;
+    }
+
+    if (m_hasPending && timestampMs - m_idleEndMs >= m_mergeGapMs) {
+        return finishPending(completed);
+    }
+    return false;
+}
+
+bool BreakDetector::flush(ActivityMonitor::BreakInterval* completed)
+{
+    return !m_idle && m_hasPending && finishPending(completed);
+}
+
+bool BreakDetector::finishPending(ActivityMonitor::BreakInterval* completed)
+{
+    m_hasPending = false;
+    if (m_idleEndMs - m_idleStartMs < m_minBreakMs) {
+        return false; // 离开时间太短，坐立时段继续
+    }
+
+    completed->startMs = m_idleStartMs;
+    completed->endMs = m_idleEndMs;
+    completed->sittingMs = qMax<qint64>(0, m_idleStartMs - m_sessionStartMs);
+    m_sessionStartMs = m_idleEndMs;
+    return true;
+}
@@ -198,6 +198,7 @@ void ConfigManager::initializeDefaults()
     m_generalConfig.soundEnabled = true;
     m_generalConfig.showNotifications = true;
     m_generalConfig.notificationDuration = 5;
+    m_generalConfig.suppressInFullscreen = true;
     
     // 初始化默认工作时间
     m_workSchedule.workStartTime = QTime(9, 0);
@@ -210,7 +211,13 @@ void ConfigManager::initializeDefaults()
     m_advancedConfig.enableLogging = true;
     m_advancedConfig.logLevel = "INFO";
     m_advancedConfig.dataRetentionDays = 30;
+    m_advancedConfig.rawRetentionDays = 7;
     m_advancedConfig.enableSmartAdaptation = true;
+    m_advancedConfig.highResolutionCapture = false;
+    m_advancedConfig.idleThresholdSeconds = 30;
+    m_advancedConfig.minBreakSeconds = 300;
+    m_advancedConfig.breakMergeGapSeconds = 60;
+    m_advancedConfig.journalCommitSeconds = 5;
     
     // 初始化默认提醒配置
     HealthEngine::ReminderConfig sittingConfig;
@@ -250,6 +257,7 @@ QJsonObject ConfigManager::configToJson() const
     general["soundEnabled"] = m_generalConfig.soundEnabled;
     general["showNotifications"] = m_generalConfig.showNotifications;
     general["notificationDuration"] = m_generalConfig.notificationDuration;
+    general["suppressInFullscreen"] = m_generalConfig.suppressInFullscreen;
     root["general"] = general;
     
     // 工作时间配置
@@ -270,7 +278,13 @@ QJsonObject ConfigManager::configToJson() const
     advanced["enableLogging"] = m_advancedConfig.enableLogging;
     advanced["logLevel"] = m_advancedConfig.logLevel;
     advanced["dataRetentionDays"] = m_advancedConfig.dataRetentionDays;
+    advanced["rawRetentionDays"] = m_advancedConfig.rawRetentionDays;
     advanced["enableSmartAdaptation"] = m_advancedConfig.enableSmartAdaptation;
+    advanced["highResolutionCapture"] = m_advancedConfig.highResolutionCapture;
+    advanced["idleThresholdSeconds"] = m_advancedConfig.idleThresholdSeconds;
+    advanced["minBreakSeconds"] = m_advancedConfig.minBreakSeconds;
+    advanced["breakMergeGapSeconds"] = m_advancedConfig.breakMergeGapSeconds;
+    advanced["journalCommitSeconds"] = m_advancedConfig.journalCommitSeconds;
     root["advanced"] = advanced;
     
     // 提醒配置
@@ -302,6 +316,7 @@ void ConfigManager::jsonToConfig(const QJsonObject& json)
         m_generalConfig.soundEnabled = general["soundEnabled"].toBool(true);
         m_generalConfig.showNotifications = general["showNotifications"].toBool(true);
         m_generalConfig.notificationDuration = general["notificationDuration"].toInt(5);
+        m_generalConfig.suppressInFullscreen = general["suppressInFullscreen"].toBool(true);
     }
     
     // 加载工作时间配置
@@ -328,7 +343,13 @@ void ConfigManager::jsonToConfig(const QJsonObject& json)
         m_advancedConfig.enableLogging = advanced["enableLogging"].toBool(true);
         m_advancedConfig.logLevel = advanced["logLevel"].toString("INFO");
         m_advancedConfig.dataRetentionDays = advanced["dataRetentionDays"].toInt(30);
+        m_advancedConfig.rawRetentionDays = qMax(1, advanced["rawRetentionDays"].toInt(7));
         m_advancedConfig.enableSmartAdaptation = advanced["enableSmartAdaptation"].toBool(true);
+        m_advancedConfig.highResolutionCapture = advanced["highResolutionCapture"].toBool(false);
+        m_advancedConfig.idleThresholdSeconds = qMax(1, advanced["idleThresholdSeconds"].toInt(30));
+        m_advancedConfig.minBreakSeconds = qMax(1, advanced["minBreakSeconds"].toInt(300));
+        m_advancedConfig.breakMergeGapSeconds = qMax(0, advanced["breakMergeGapSeconds"].toInt(60));
+        m_advancedConfig.journalCommitSeconds = qMax(1, advanced["journalCommitSeconds"].toInt(5));
     }
     
     // 加载提醒配置
@@ -1,65 +1,252 @@
 
 #include "core/DataAnalyzer.h"
+#include "utils/Logger.h"
+#include "utils/MonotonicClock.h"
+#include "utils/StorageWriter.h"
+#include "utils/StringInternPool.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QStandardPaths>
 #include <QDir>
+#include <QHash>
 #include <QDebug>
+#include <algorithm>
 
-DataAnalyzer::DataAnalyzer(QObject *parent)
+namespace {
+// 每 5 分钟分析一次并保存
+constexpr int kAnalysisIntervalMs = 5 * 60 * 1000;
+// 缓存最近查询的天数（一周加今天）
+constexpr int kMaxCachedDays = 8;
+// 默认的日志组提交间隔
+constexpr int kDefaultCommitIntervalMs = 5 * 1000;
+}
+
+DataAnalyzer::DataAnalyzer(const QString& dataFilePath, QObject *parent)
     : QObject(parent), m_lastAnalysisTime(QDateTime::currentDateTime())
+    , m_rawRetentionDays(0), m_retentionDays(0), m_compacting(false), m_dataFilePath(dataFilePath)
 {
+    m_compactionPool.setMaxThreadCount(1);
+
+    const QString path = getDataFilePath();
+    if (!path.isEmpty()) {
+        m_journal = std::make_unique<ActivityJournal>(ActivityJournal::pathForDataFile(path));
+    }
+
+    // 单次定时器：第一条未提交的记录启动它，到时把期间的记录一次追加并落盘
+    m_commitTimer = new QTimer(this);
+    m_commitTimer->setSingleShot(true);
+    m_commitTimer->setInterval(kDefaultCommitIntervalMs);
+    connect(m_commitTimer, &QTimer::timeout, this, &DataAnalyzer::commitJournal);
+
     loadDataFromFile();
 
     m_analysisTimer = new QTimer(this);
     connect(m_analysisTimer, &QTimer::timeout, this, &DataAnalyzer::analyzePatterns);
-    // 每 5 分钟分析一次并保存
-    m_analysisTimer->start(1000 * 60 * 5); 
+    m_analysisTimer->start(kAnalysisIntervalMs);
 }
 
 DataAnalyzer::~DataAnalyzer()
 {
+    // 未完成的压缩结果随本对象一起丢弃，原段文件不受影响
+    m_compactionPool.waitForDone();
     saveDataToFile();
 }
 
+void DataAnalyzer::setStorageWriter(StorageWriter* writer)
+{
+    if (m_journal) {
+        m_journal->setStorageWriter(writer);
+    }
+}
+
+void DataAnalyzer::setCommitInterval(int intervalMs)
+{
+    m_commitTimer->setInterval(qMax(1, intervalMs));
+}
+
+void DataAnalyzer::setRetention(int rawDays, int retentionDays)
+{
+    m_rawRetentionDays = qMax(1, rawDays);
+    m_retentionDays = qMax(1, retentionDays);
+    cleanupOldData(m_retentionDays);
+}
+
+template <typename Record>
+void DataAnalyzer::appendToJournal(const Record& record)
+{
+    if (m_journal) {
+        m_journal->append(record);
+        if (!m_commitTimer->isActive()) {
+            m_commitTimer->start();
+        }
+    }
+}
+
+void DataAnalyzer::commitJournal()
+{
+    // 失败的记录留在内存中稍后重试；交给写入器的记录要到下次提交才能确认落盘
+    if (m_journal && (!m_journal->commit() || m_journal->hasPendingData())) {
+        m_commitTimer->start();
+    }
+}
+
 void DataAnalyzer::recordActivity(const ActivityMonitor::ActivityData& data)
 {
-    ActivityRecord record;
-    record.timestamp = data.timestamp;
-    record.data = data;
-    m_activityRecords.append(record);
+    if (DayData* day = cachedDay(data.timestamp.date())) {
+        day->activities.append(data);
+    }
+    appendToJournal(data);
+    emit dataUpdated();
+}
+
+void DataAnalyzer::recordActivityBatch(const ActivityMonitor::ActivityBatch& batch)
+{
+    for (const auto& data : batch) {
+        if (DayData* day = cachedDay(data.timestamp.date())) {
+            day->activities.append(data);
+        }
+        appendToJournal(data);
+    }
+    emit dataUpdated();
+}
+
+void DataAnalyzer::recordActivityBucket(const ActivityMonitor::ActivityBucket& bucket)
+{
+    if (DayData* day = cachedDay(ActivityJournal::dayOf(bucket.minuteStartMs))) {
+        day->buckets.append(bucket);
+    }
+    appendToJournal(bucket);
+    emit dataUpdated();
+}
+
+void DataAnalyzer::recordFocusInterval(const ActivityMonitor::FocusInterval& interval)
+{
+    if (DayData* day = cachedDay(ActivityJournal::dayOf(interval.startMs))) {
+        day->focusIntervals.append(interval);
+    }
+    appendToJournal(interval);
+    emit dataUpdated();
+}
+
+void DataAnalyzer::recordBreak(const ActivityMonitor::BreakInterval& interval)
+{
+    if (DayData* day = cachedDay(ActivityJournal::dayOf(interval.startMs))) {
+        day->breaks.append(interval);
+    }
+    appendToJournal(interval);
     emit dataUpdated();
 }
 
 void DataAnalyzer::recordHealthEvent(HealthEngine::ReminderType type, const QString& action)
 {
     HealthEventRecord record;
-    record.timestamp = QDateTime::currentDateTime();
+    record.timestampMs = MonotonicClock::currentUnixMs();
     record.type = type;
     record.action = action;
-    m_healthEvents.append(record);
+    if (DayData* day = cachedDay(ActivityJournal::dayOf(record.timestampMs))) {
+        day->healthEvents.append(record);
+    }
+    appendToJournal(record);
     emit dataUpdated();
 }
 
+DataAnalyzer::DayData* DataAnalyzer::cachedDay(const QDate& date)
+{
+    // 未缓存的日子不必加载：记录已进入日志，下次查询时连同段文件一起读出
+    auto it = m_days.find(date);
+    if (it != m_days.end()) {
+        return &it.value();
+    }
+    return m_journal ? nullptr : &m_days[date];
+}
+
+const DataAnalyzer::DayData& DataAnalyzer::dayData(const QDate& date) const
+{
+    m_recentDays.removeOne(date);
+    m_recentDays.append(date);
+
+    auto it = m_days.constFind(date);
+    if (it != m_days.constEnd()) {
+        return it.value();
+    }
+
+    DayData& day = m_days[date];
+    if (m_journal) {
+        // 只读取当天的段；缓存最近查询的几天，更早的按需重新读取
+        ActivityJournal::Contents contents;
+        m_journal->loadDay(date, &contents);
+        for (const auto& data : contents.activities) {
+            day.activities.append(data);
+        }
+        day.buckets = std::move(contents.buckets);
+        day.focusIntervals = std::move(contents.focusIntervals);
+        day.breaks = std::move(contents.breaks);
+        day.healthEvents = std::move(contents.healthEvents);
+        while (m_recentDays.size() > kMaxCachedDays) {
+            m_days.remove(m_recentDays.takeFirst());
+        }
+    }
+    return day;
+}
+
+bool DataAnalyzer::hasDay(const QDate& date) const
+{
+    return m_journal ? m_journal->hasDay(date) : m_days.contains(date);
+}
+
+ActivityJournal::DaySummary DataAnalyzer::daySummary(const QDate& date) const
+{
+    if (m_journal) {
+        return m_journal->summary(date);
+    }
+    auto it = m_days.constFind(date);
+    return it != m_days.constEnd() ? summarize(it.value()) : ActivityJournal::DaySummary();
+}
+
+ActivityJournal::DaySummary DataAnalyzer::summarize(const DayData& day)
+{
+    ActivityJournal::DaySummary summary;
+    summary.activeSamples = day.activities.activeCount();
+    summary.buckets = day.buckets.size();
+    for (const auto& bucket : day.buckets) {
+        summary.activeSeconds += bucket.activeSeconds;
+        summary.mouseClicks += bucket.mouseClicks;
+        summary.keystrokes += bucket.keystrokes;
+    }
+    summary.breaks = day.breaks.size();
+    for (const auto& interval : day.breaks) {
+        summary.longestSittingMs = qMax(summary.longestSittingMs, interval.sittingMs);
+    }
+    summary.healthEvents = day.healthEvents.size();
+    summary.records = day.activities.size() + day.buckets.size() + day.focusIntervals.size() +
+                      day.breaks.size() + summary.healthEvents;
+    return summary;
+}
+
 DataAnalyzer::DailyReport DataAnalyzer::getDailyReport(const QDate& date) const
 {
     // TODO: 实现详细的日报生成逻辑
     DailyReport report;
     report.date = date;
-    report.totalActiveMinutes = 0;
-    report.totalBreaks = 0;
-    report.longestSittingSession = 0;
+    // 按列扫描当天的记录：活跃秒数只读打包的活跃位
+    const DayData& day = dayData(date);
+    const ActivityJournal::DaySummary summary = summarize(day);
+    report.totalBreaks = summary.breaks;
+    report.longestSittingSession = static_cast<int>(summary.longestSittingMs / 60000);
     report.healthScore = 0.0;
 
-    for (const auto& record : m_activityRecords) {
-        if (record.timestamp.date() == date) {
-            if (record.data.isActive) {
-                report.totalActiveMinutes++; // 假设每条记录代表1分钟
-            }
-        }
+    LogHistogram keyIntervals;
+    for (const auto& bucket : day.buckets) {
+        keyIntervals.merge(bucket.keyIntervals);
     }
+    report.keyIntervalP50Ms = keyIntervals.percentile(50);
+    report.keyIntervalP95Ms = keyIntervals.percentile(95);
+
+    // 没有分钟桶的旧数据：按逐秒记录统计
+    const int activeSeconds = summary.buckets > 0 ? summary.activeSeconds : summary.activeSamples;
+    report.totalActiveMinutes = activeSeconds / 60;
     return report;
 }
 
@@ -69,11 +256,112 @@ DataAnalyzer::WeeklyTrend DataAnalyzer::getWeeklyTrend(const QDate& weekStart) c
     WeeklyTrend trend;
     trend.weekStart = weekStart;
     trend.avgHealthScore = 0.0;
-    trend.totalActiveHours = 0;
     trend.totalBreaks = 0;
+
+    // 有日志时只读清单中每天的汇总，不读取段文件；否则按列扫描内存中的记录
+    int activeSeconds = 0;
+    for (int day = 0; day < 7; ++day) {
+        const ActivityJournal::DaySummary summary = daySummary(weekStart.addDays(day));
+        trend.totalBreaks += summary.breaks;
+        activeSeconds += summary.buckets > 0 ? summary.activeSeconds : summary.activeSamples;
+    }
+    trend.totalActiveHours = activeSeconds / 3600;
     return trend;
 }
 
+QList<DataAnalyzer::HourlyMouseLoad> DataAnalyzer::getHourlyMouseLoad(const QDate& date) const
+{
+    QList<HourlyMouseLoad> hours;
+    for (int hour = 0; hour < 24; ++hour) {
+        hours.append({hour, 0.0, 0.0, 0, 0});
+    }
+
+    for (const auto& bucket : dayData(date).buckets) {
+        const QDateTime minuteStart = QDateTime::fromMSecsSinceEpoch(bucket.minuteStartMs);
+        HourlyMouseLoad& load = hours[minuteStart.time().hour()];
+        load.pointerDistance += bucket.pointerDistance;
+        load.peakVelocity = qMax(load.peakVelocity, bucket.peakVelocity);
+        load.mouseClicks += bucket.mouseClicks;
+        load.wheelTicks += bucket.wheelTicks;
+    }
+    return hours;
+}
+
+LogHistogram DataAnalyzer::getKeyIntervalHistogram(const QDate& startDate, const QDate& endDate) const
+{
+    LogHistogram histogram;
+    for (QDate date = startDate; date.isValid() && date <= endDate; date = date.addDays(1)) {
+        if (!hasDay(date)) {
+            continue;
+        }
+        for (const auto& bucket : dayData(date).buckets) {
+            histogram.merge(bucket.keyIntervals);
+        }
+    }
+    return histogram;
+}
+
+QList<ActivityMonitor::FocusInterval> DataAnalyzer::getFocusIntervals(const QDate& date) const
+{
+    return dayData(date).focusIntervals;
+}
+
+QList<DataAnalyzer::ApplicationUsage> DataAnalyzer::getApplicationUsage(const QDate& date) const
+{
+    // 区间已携带应用程序 ID，按整数分组即可，名称只在输出时解析
+    QHash<quint32, ApplicationUsage> usage;
+    for (const auto& interval : dayData(date).focusIntervals) {
+        if (interval.applicationId == StringInternPool::EmptyId) {
+            continue;
+        }
+        ApplicationUsage& entry = usage[interval.applicationId];
+        entry.applicationId = interval.applicationId;
+        entry.activeSeconds += interval.activeSeconds;
+        entry.focusedSeconds += static_cast<int>((interval.endMs - interval.startMs) / 1000);
+        entry.focusCount++;
+    }
+
+    QList<ApplicationUsage> result = usage.values();
+    for (ApplicationUsage& entry : result) {
+        entry.applicationName = StringInternPool::applications().resolve(entry.applicationId);
+    }
+    std::sort(result.begin(), result.end(), [](const ApplicationUsage& a, const ApplicationUsage& b) {
+        return a.activeSeconds > b.activeSeconds;
+    });
+    return result;
+}
+
+DataAnalyzer::FocusSummary DataAnalyzer::getFocusSummary(const QDate& date) const
+{
+    FocusSummary summary = {0, 0, 0.0, 0};
+    int activeSeconds = 0;
+    quint32 previousApplicationId = StringInternPool::EmptyId;
+    qint64 runStartMs = 0;
+    qint64 runEndMs = 0;
+
+    for (const auto& interval : dayData(date).focusIntervals) {
+        summary.intervalCount++;
+        activeSeconds += interval.activeSeconds;
+
+        // 同一应用内切换标签页或文档不算上下文切换
+        if (summary.intervalCount == 1 || interval.applicationId != previousApplicationId) {
+            if (summary.intervalCount > 1) {
+                summary.applicationSwitches++;
+            }
+            previousApplicationId = interval.applicationId;
+            runStartMs = interval.startMs;
+        }
+        runEndMs = interval.endMs;
+        summary.longestFocusSeconds = qMax(summary.longestFocusSeconds,
+                                           static_cast<int>((runEndMs - runStartMs) / 1000));
+    }
+
+    if (activeSeconds > 0) {
+        summary.switchesPerHour = summary.applicationSwitches * 3600.0 / activeSeconds;
+    }
+    return summary;
+}
+
 QList<DataAnalyzer::HealthInsight> DataAnalyzer::getHealthInsights() const
 {
     // TODO: 实现健康洞察生成逻辑
@@ -86,60 +374,128 @@ QString DataAnalyzer::getStatsSummary() const
     return QString("今日已专注工作 %1 小时 %2 分钟。").arg(activeMinutesToday / 60).arg(activeMinutesToday % 60);
 }
 
+void DataAnalyzer::cleanupOldData(int retentionDays)
+{
+    const QDate today = QDate::currentDate();
+    const QDate rawCutoff = today.addDays(-(m_rawRetentionDays > 0 ? m_rawRetentionDays : retentionDays));
+    const QDate minuteCutoff = today.addDays(-qMax(1, retentionDays));
+    m_lastCleanupDate = today;
+
+    if (!m_journal) {
+        // 没有日志时数据只在内存中，丢弃过期的逐秒记录即可
+        for (auto it = m_days.begin(); it != m_days.end(); ++it) {
+            if (it.key() < rawCutoff) {
+                it->activities.clear();
+            }
+        }
+        return;
+    }
+
+    m_compactionQueue.clear();
+    for (const QDate& date : m_journal->days()) {
+        ActivityJournal::Tier target = ActivityJournal::Tier::Raw;
+        if (date < minuteCutoff) {
+            target = ActivityJournal::Tier::Hourly;
+        } else if (date < rawCutoff) {
+            target = ActivityJournal::Tier::Minute;
+        }
+        if (target > m_journal->summary(date).tier) {
+            m_compactionQueue.append({date, target});
+        }
+    }
+    startNextCompaction();
+}
+
+void DataAnalyzer::startNextCompaction()
+{
+    if (m_compacting || !m_journal) {
+        return;
+    }
+    // 保留天数变化时队列会重建，跳过已经压缩到位的日子
+    while (!m_compactionQueue.isEmpty() &&
+           m_compactionQueue.first().target <= m_journal->summary(m_compactionQueue.first().date).tier) {
+        m_compactionQueue.removeFirst();
+    }
+    if (m_compactionQueue.isEmpty()) {
+        return;
+    }
+
+    // 一次压缩一天：工作线程只读段文件生成新内容，替换与清单更新回到本线程进行
+    const CompactionTask task = m_compactionQueue.takeFirst();
+    const QString path = m_journal->segmentPath(task.date);
+    m_compacting = true;
+    m_compactionPool.start([this, task, path]() {
+        const ActivityJournal::Compaction compaction = ActivityJournal::compactSegment(path, task.target);
+        QMetaObject::invokeMethod(this, [this, task, compaction]() {
+            finishCompaction(task.date, compaction);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DataAnalyzer::finishCompaction(const QDate& date, const ActivityJournal::Compaction& compaction)
+{
+    m_compacting = false;
+    if (m_journal && m_journal->applyCompaction(date, compaction)) {
+        m_days.remove(date);
+        m_recentDays.removeOne(date);
+        emit dataUpdated();
+    }
+    startNextCompaction();
+}
+
 void DataAnalyzer::saveDataToFile()
 {
-    QString path = getDataFilePath();
-    if (path.isEmpty()) {
+    if (!m_journal) {
         qWarning() << "Could not get data file path. Data not saved.";
         return;
     }
 
-    QJsonObject rootObj;
-    
-    QJsonArray activitiesArray;
-    for (const auto& record : m_activityRecords) {
-        QJsonObject activityObj;
-        activityObj["timestamp"] = record.timestamp.toString(Qt::ISODate);
-        activityObj["mouseClicks"] = record.data.mouseClicks;
-        activityObj["keystrokes"] = record.data.keystrokes;
-        activityObj["isActive"] = record.data.isActive;
-        activityObj["activeWindow"] = record.data.activeWindow;
-        activitiesArray.append(activityObj);
-    }
-    rootObj["activities"] = activitiesArray;
-
-    QJsonArray healthEventsArray;
-    for (const auto& record : m_healthEvents) {
-        QJsonObject eventObj;
-        eventObj["timestamp"] = record.timestamp.toString(Qt::ISODate);
-        eventObj["type"] = static_cast<int>(record.type);
-        eventObj["action"] = record.action;
-        healthEventsArray.append(eventObj);
-    }
-    rootObj["health_events"] = healthEventsArray;
-
-    QJsonDocument doc(rootObj);
-    QFile file(path);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-    } else {
-        qWarning() << "Could not open file for writing:" << path;
+    // 提交未提交的记录，并保存清单快照
+    m_journal->flush();
+    if (!m_journal->hasPendingData()) {
+        m_commitTimer->stop();
     }
 }
 
 void DataAnalyzer::loadDataFromFile()
 {
-    QString path = getDataFilePath();
-    if (path.isEmpty() || !QFile::exists(path)) {
-        qWarning() << "Data file does not exist, starting fresh:" << path;
+    m_days.clear();
+    m_recentDays.clear();
+
+    if (!m_journal) {
+        qWarning() << "Could not get data file path, starting fresh.";
+        return;
+    }
+
+    if (!m_journal->open()) {
+        qWarning() << "Could not open activity journal, data will not be saved:" << m_journal->directory();
+        m_journal.reset();
         return;
     }
 
+    // 旧版 JSON 文件只迁移到空日志中：日志已有数据时说明迁移已完成（只是改名失败）
+    // 或者文件是旧版本后来写的，都不再导入，也不动日志里已有的段
+    const QString legacyPath = getDataFilePath();
+    if (QFile::exists(legacyPath)) {
+        if (!m_journal->days().isEmpty()) {
+            Logger::warning(QString("活动日志已有数据，不再迁移 %1").arg(legacyPath), "DataAnalyzer");
+        } else if (migrateLegacyDataFile(legacyPath) && !m_journal->open()) {
+            qWarning() << "Could not open activity journal, data will not be saved:" << m_journal->directory();
+            m_journal.reset();
+            return;
+        }
+    } else if (m_journal->days().isEmpty()) {
+        qWarning() << "Data file does not exist, starting fresh:" << m_journal->directory();
+    }
+    emit dataUpdated();
+}
+
+bool DataAnalyzer::migrateLegacyDataFile(const QString& path)
+{
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Could not open file for reading:" << path;
-        return;
+        return false;
     }
 
     QByteArray data = file.readAll();
@@ -148,25 +504,95 @@ void DataAnalyzer::loadDataFromFile()
     QJsonDocument doc = QJsonDocument::fromJson(data);
     if (doc.isNull() || !doc.isObject()) {
         qWarning() << "Failed to parse data file, it might be corrupted.";
-        return;
+        return false;
     }
 
     QJsonObject rootObj = doc.object();
-    m_activityRecords.clear();
-    m_healthEvents.clear();
+    ActivityJournal::Contents legacy;
+
+    // 文件中的标题 ID 只在该文件内有效，加载时映射到本进程的驻留池
+    QHash<qint64, quint32> titleIds;
+    QJsonObject titlesObj = rootObj["titles"].toObject();
+    for (auto it = titlesObj.begin(); it != titlesObj.end(); ++it) {
+        titleIds.insert(it.key().toLongLong(), StringInternPool::titles().intern(it.value().toString()));
+    }
+    QHash<qint64, quint32> applicationIds;
+    QJsonObject applicationsObj = rootObj["applications"].toObject();
+    for (auto it = applicationsObj.begin(); it != applicationsObj.end(); ++it) {
+        applicationIds.insert(it.key().toLongLong(), StringInternPool::applications().intern(it.value().toString()));
+    }
 
     if (rootObj.contains("activities") && rootObj["activities"].isArray()) {
         QJsonArray activitiesArray = rootObj["activities"].toArray();
         for (const auto& val : activitiesArray) {
             QJsonObject obj = val.toObject();
-            ActivityRecord record;
-            record.timestamp = QDateTime::fromString(obj["timestamp"].toString(), Qt::ISODate);
-            record.data.timestamp = record.timestamp;
-            record.data.mouseClicks = obj["mouseClicks"].toInt();
-            record.data.keystrokes = obj["keystrokes"].toInt();
-            record.data.isActive = obj["isActive"].toBool();
-            record.data.activeWindow = obj["activeWindow"].toString();
-            m_activityRecords.append(record);
+            ActivityMonitor::ActivityData data;
+            data.timestamp = QDateTime::fromString(obj["timestamp"].toString(), Qt::ISODate);
+            data.mouseClicks = obj["mouseClicks"].toInt();
+            data.keystrokes = obj["keystrokes"].toInt();
+            data.isActive = obj["isActive"].toBool();
+            data.pointerDistance = obj["pointerDistance"].toDouble();
+            data.pointerVelocity = obj["pointerVelocity"].toDouble();
+            data.wheelTicks = obj["wheelTicks"].toInt();
+            data.applicationId = applicationIds.value(obj["appId"].toInteger(), StringInternPool::EmptyId);
+            if (obj.contains("titleId")) {
+                data.windowTitleId = titleIds.value(obj["titleId"].toInteger(), StringInternPool::EmptyId);
+            } else {
+                // 兼容旧格式：每条记录直接保存标题字符串
+                data.windowTitleId = StringInternPool::titles().intern(obj["activeWindow"].toString());
+            }
+            legacy.activities.append(data);
+        }
+    }
+
+    if (rootObj.contains("buckets") && rootObj["buckets"].isArray()) {
+        QJsonArray bucketsArray = rootObj["buckets"].toArray();
+        for (const auto& val : bucketsArray) {
+            QJsonObject obj = val.toObject();
+            ActivityMonitor::ActivityBucket bucket;
+            bucket.minuteStartMs = obj["minuteStart"].toInteger();
+            bucket.activeSeconds = obj["activeSeconds"].toInt();
+            bucket.mouseClicks = obj["mouseClicks"].toInt();
+            bucket.keystrokes = obj["keystrokes"].toInt();
+            bucket.dominantWindowTitleId = titleIds.value(obj["titleId"].toInteger(), StringInternPool::EmptyId);
+            bucket.pointerDistance = obj["pointerDistance"].toDouble();
+            bucket.peakVelocity = obj["peakVelocity"].toDouble();
+            bucket.meanVelocity = obj["meanVelocity"].toDouble();
+            bucket.wheelTicks = obj["wheelTicks"].toInt();
+            bucket.dominantApplicationId = applicationIds.value(obj["appId"].toInteger(), StringInternPool::EmptyId);
+            const QJsonArray keyIntervalsArray = obj["keyIntervals"].toArray();
+            for (int i = 0; i < keyIntervalsArray.size() && i < LogHistogram::BucketCount; ++i) {
+                bucket.keyIntervals.setCount(i, static_cast<quint32>(keyIntervalsArray.at(i).toInteger()));
+            }
+            legacy.buckets.append(bucket);
+        }
+    }
+
+    if (rootObj.contains("focus_intervals") && rootObj["focus_intervals"].isArray()) {
+        QJsonArray focusArray = rootObj["focus_intervals"].toArray();
+        for (const auto& val : focusArray) {
+            QJsonObject obj = val.toObject();
+            ActivityMonitor::FocusInterval interval;
+            interval.startMs = obj["start"].toInteger();
+            interval.endMs = obj["end"].toInteger();
+            interval.applicationId = applicationIds.value(obj["appId"].toInteger(), StringInternPool::EmptyId);
+            interval.windowTitleId = titleIds.value(obj["titleId"].toInteger(), StringInternPool::EmptyId);
+            interval.activeSeconds = obj["activeSeconds"].toInt();
+            interval.mouseClicks = obj["mouseClicks"].toInt();
+            interval.keystrokes = obj["keystrokes"].toInt();
+            legacy.focusIntervals.append(interval);
+        }
+    }
+
+    if (rootObj.contains("breaks") && rootObj["breaks"].isArray()) {
+        QJsonArray breaksArray = rootObj["breaks"].toArray();
+        for (const auto& val : breaksArray) {
+            QJsonObject obj = val.toObject();
+            ActivityMonitor::BreakInterval interval;
+            interval.startMs = obj["start"].toInteger();
+            interval.endMs = obj["end"].toInteger();
+            interval.sittingMs = obj["sitting"].toInteger();
+            legacy.breaks.append(interval);
         }
     }
 
@@ -175,17 +601,34 @@ void DataAnalyzer::loadDataFromFile()
         for (const auto& val : healthEventsArray) {
             QJsonObject obj = val.toObject();
             HealthEventRecord record;
-            record.timestamp = QDateTime::fromString(obj["timestamp"].toString(), Qt::ISODate);
+            record.timestampMs = QDateTime::fromString(obj["timestamp"].toString(), Qt::ISODate).toMSecsSinceEpoch();
             record.type = static_cast<HealthEngine::ReminderType>(obj["type"].toInt());
             record.action = obj["action"].toString();
-            m_healthEvents.append(record);
+            legacy.healthEvents.append(record);
         }
     }
-    emit dataUpdated();
+
+    // 先写入临时目录，全部落盘后才替换为日志目录；失败时日志保持为空，下次启动重新迁移
+    if (!ActivityJournal::create(m_journal->directory(), legacy)) {
+        qWarning() << "Could not migrate data file to journal:" << m_journal->directory();
+        return false;
+    }
+    Logger::info(QString("已将 %1 迁移为活动日志 %2").arg(path, m_journal->directory()), "DataAnalyzer");
+
+    // 改名失败时旧文件原样保留；日志已有数据，下次启动不会再导入
+    QFile::remove(path + ".migrated");
+    if (!QFile::rename(path, path + ".migrated")) {
+        Logger::warning(QString("无法将 %1 改名为 .migrated").arg(path), "DataAnalyzer");
+    }
+    return true;
 }
 
 QString DataAnalyzer::getDataFilePath() const
 {
+    if (!m_dataFilePath.isEmpty()) {
+        return m_dataFilePath;
+    }
+
     QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
     if (dataDir.isEmpty()) {
         return "";
@@ -202,10 +645,28 @@ QString DataAnalyzer::getDataFilePath() const
     return dataDir + "/activity_log.json";
 }
 
+void DataAnalyzer::onScreenLockChanged(bool locked)
+{
+    if (locked) {
+        // 锁屏期间不会有新数据，保存一次后不再定期唤醒
+        if (m_analysisTimer->isActive()) {
+            m_analysisTimer->stop();
+            analyzePatterns();
+        }
+    } else if (!m_analysisTimer->isActive()) {
+        m_analysisTimer->start(kAnalysisIntervalMs);
+    }
+}
+
 void DataAnalyzer::analyzePatterns()
 {
     // TODO: 实现模式分析逻辑
     generateInsights();
+
+    // 设置了保留天数后，每天检查一次需要压缩的旧数据（回放等场景不压缩）
+    if (m_retentionDays > 0 && m_lastCleanupDate != QDate::currentDate()) {
+        cleanupOldData(m_retentionDays);
+    }
     
     // 定期保存数据
     saveDataToFile();
@@ -0,0 +1,247 @@
+#include "core/EvdevInputSource.h"
+#include "utils/Logger.h"
+#include "utils/MonotonicClock.h"
+#include <QDir>
+#include <QFile>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kMaxEpollEvents = 16;
+constexpr int kReadBatch = 64; // 每次 read() 最多读取的 input_event 数
+
+bool isMouseButton(unsigned short code)
+{
+    return code == BTN_LEFT || code == BTN_RIGHT || code == BTN_MIDDLE || code == BTN_TOUCH;
+}
+
+bool isKeyboardKey(unsigned short code)
+{
+    // BTN_MISC..BTN_GEAR_UP 之间是鼠标、手柄等按钮，不算键盘输入
+    return code < BTN_MISC || (code >= KEY_OK && code < BTN_DPAD_UP);
+}
+
+} // namespace
+
+EvdevInputSource::EvdevInputSource(const QStringList& devicePaths, QObject *parent)
+    : InputSource(parent)
+    , m_devicePaths(devicePaths)
+    , m_epollFd(-1)
+    , m_notifier(nullptr)
+    , m_lastInputMs(MonotonicClock::milliseconds())
+{
+}
+
+EvdevInputSource::~EvdevInputSource()
+{
+    close();
+}
+
+bool EvdevInputSource::open()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        Logger::error(QString("epoll_create1 失败: %1").arg(qt_error_string(errno)), "EvdevInputSource");
+        return false;
+    }
+
+    QStringList paths = m_devicePaths;
+    if (paths.isEmpty()) {
+        QDir inputDir("/dev/input");
+        const QStringList entries = inputDir.entryList(QStringList() << "event*", QDir::System);
+        for (const QString& entry : entries) {
+            paths << inputDir.filePath(entry);
+        }
+    }
+
+    for (const QString& path : paths) {
+        int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            Logger::debug(QString("无法打开输入设备 %1: %2").arg(path, qt_error_string(errno)), "EvdevInputSource");
+            continue;
+        }
+        addFileDescriptor(fd);
+    }
+
+    // 一个通知器监听 epoll 描述符，任意设备可读时唤醒
+    m_notifier = new QSocketNotifier(m_epollFd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &EvdevInputSource::readEvents);
+
+    if (m_fds.isEmpty() && m_devicePaths.isEmpty()) {
+        Logger::warning("没有可读取的输入设备，请检查是否属于 input 用户组", "EvdevInputSource");
+        close();
+        return false;
+    }
+
+    Logger::info(QString("evdev 后端已打开 %1 个输入设备").arg(m_fds.size()), "EvdevInputSource");
+    return true;
+}
+
+void EvdevInputSource::close()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+
+    for (int fd : m_fds) {
+        ::close(fd);
+    }
+    m_fds.clear();
+
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+bool EvdevInputSource::addFileDescriptor(int fd)
+{
+    if (m_epollFd < 0 || fd < 0) {
+        return false;
+    }
+
+    // 管道等描述符也需要非阻塞，以便批量读取到 EAGAIN 为止
+    int flags = fcntl(fd, F_GETFL);
+    if (flags >= 0 && !(flags & O_NONBLOCK)) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        Logger::warning(QString("epoll_ctl 添加描述符失败: %1").arg(qt_error_string(errno)), "EvdevInputSource");
+        ::close(fd);
+        return false;
+    }
+
+    m_fds.append(fd);
+    return true;
+}
+
+void EvdevInputSource::poll()
+{
+    // 采样前处理尚未被通知器投递的数据
+    readEvents();
+}
+
+int EvdevInputSource::idleMilliseconds()
+{
+    return static_cast<int>(qMin<qint64>(MonotonicClock::milliseconds() - m_lastInputMs, INT_MAX));
+}
+
+void EvdevInputSource::readEvents()
+{
+    if (m_epollFd < 0) return;
+
+    epoll_event ready[kMaxEpollEvents];
+    int count;
+    bool sawInput = false;
+    do {
+        count = epoll_wait(m_epollFd, ready, kMaxEpollEvents, 0);
+        for (int i = 0; i < count; ++i) {
+            sawInput = drainDescriptor(ready[i].data.fd) || sawInput;
+        }
+    } while (count == kMaxEpollEvents);
+
+    if (sawInput) {
+        m_lastInputMs = MonotonicClock::milliseconds();
+        emit inputReceived();
+    }
+}
+
+bool EvdevInputSource::drainDescriptor(int fd)
+{
+    input_event events[kReadBatch];
+    bool sawInput = false;
+
+    // 同一帧（SYN_REPORT 之前）的 REL_X/REL_Y 合成一次位移
+    int frameDx = 0;
+    int frameDy = 0;
+
+    for (;;) {
+        ssize_t bytes = ::read(fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                // ENODEV：设备已拔出
+                removeDescriptor(fd);
+            }
+            break;
+        }
+        if (bytes == 0) {
+            // 管道写端已关闭
+            removeDescriptor(fd);
+            break;
+        }
+
+        const int n = static_cast<int>(bytes / sizeof(input_event));
+        for (int i = 0; i < n; ++i) {
+            const input_event& ev = events[i];
+            switch (ev.type) {
+            case EV_KEY:
+                sawInput = true;
+                // value: 1 按下，0 释放，2 自动重复
+                if (ev.value != 1) break;
+                if (isMouseButton(ev.code)) {
+                    m_counters.mouseClicks++;
+                } else if (isKeyboardKey(ev.code)) {
+                    m_counters.addKeystroke(static_cast<qint64>(ev.input_event_sec) * 1000 + ev.input_event_usec / 1000);
+                }
+                break;
+            case EV_REL:
+                sawInput = true;
+                if (ev.code == REL_X || ev.code == REL_Y) {
+                    m_counters.motionEvents++;
+                    (ev.code == REL_X ? frameDx : frameDy) += ev.value;
+                } else if (ev.code == REL_WHEEL || ev.code == REL_HWHEEL) {
+                    m_counters.wheelTicks += std::abs(ev.value);
+                }
+                break;
+            case EV_ABS:
+                // 绝对坐标设备的单位不是像素，只计事件数不计距离
+                sawInput = true;
+                if (ev.code == ABS_X || ev.code == ABS_Y) {
+                    m_counters.motionEvents++;
+                }
+                break;
+            case EV_SYN:
+                if (ev.code == SYN_REPORT && (frameDx != 0 || frameDy != 0)) {
+                    m_counters.pointerDistance += std::hypot(frameDx, frameDy);
+                    frameDx = 0;
+                    frameDy = 0;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (bytes < static_cast<ssize_t>(sizeof(events))) {
+            break;
+        }
+    }
+
+    if (frameDx != 0 || frameDy != 0) {
+        m_counters.pointerDistance += std::hypot(frameDx, frameDy);
+    }
+    return sawInput;
+}
+
+void EvdevInputSource::removeDescriptor(int fd)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    m_fds.removeOne(fd);
+}
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,69 @@
+#include "core/FocusTracker.h"
+#include <QtGlobal>
+
+namespace {
+
+constexpr qint64 kNominalSampleMs = 1000; // 与分钟聚合一致：长间隔后的活跃采样只按 1 秒计
+
+} // namespace
+
+FocusTracker::FocusTracker()
+    : m_hasInterval(false)
+    , m_current()
+    , m_activeMilliseconds(0)
+    , m_lastTimestampMs(0)
+{
+}
+
+bool FocusTracker::add(qint64 timestampMs, bool isActive, int clickDelta, int keyDelta,
+                       quint32 windowTitleId, quint32 applicationId,
+                       ActivityMonitor::FocusInterval* completed)
+{
+    bool finished = false;
+    if (m_hasInterval &&
+        (windowTitleId != m_current.windowTitleId || applicationId != m_current.applicationId)) {
+        // 切换发生在上一个采样与本采样之间，以本采样时间作为分界
+        m_current.endMs = timestampMs;
+        finishInterval(completed);
+        finished = true;
+    }
+
+    if (!m_hasInterval) {
+        m_hasInterval = true;
+        m_current = ActivityMonitor::FocusInterval();
+        m_current.startMs = timestampMs;
+        m_current.windowTitleId = windowTitleId;
+        m_current.applicationId = applicationId;
+        m_activeMilliseconds = 0;
+    }
+
+    if (isActive) {
+        qint64 elapsedMs = kNominalSampleMs;
+        if (m_lastTimestampMs > 0 && timestampMs > m_lastTimestampMs) {
+            elapsedMs = qMin(timestampMs - m_lastTimestampMs, kNominalSampleMs);
+        }
+        m_activeMilliseconds += elapsedMs;
+    }
+    m_lastTimestampMs = timestampMs;
+
+    m_current.endMs = timestampMs;
+    m_current.mouseClicks += qMax(0, clickDelta);
+    m_current.keystrokes += qMax(0, keyDelta);
+    return finished;
+}
+
+bool FocusTracker::flush(ActivityMonitor::FocusInterval* completed)
+{
+    if (!m_hasInterval) {
+        return false;
+    }
+    finishInterval(completed);
+    return true;
+}
+
+void FocusTracker::finishInterval(ActivityMonitor::FocusInterval* completed)
+{
+    m_current.activeSeconds = static_cast<int>((m_activeMilliseconds + 500) / 1000);
+    *completed = m_current;
+    m_hasInterval = false;
+}
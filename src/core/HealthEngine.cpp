@@ -1,18 +1,31 @@
 #include "core/HealthEngine.h"
 #include "utils/Logger.h"
+#include "utils/MonotonicClock.h"
 #include <QDateTime>
 
+namespace {
+
+constexpr int kSittingMinuteThresholdSeconds = 30; // 一分钟内活跃超过半分钟才计为坐立
+constexpr qint64 kMinSuspendNs = 60LL * 1000 * 1000 * 1000; // 挂起超过 1 分钟视为离开座位
+
+} // namespace
+
 HealthEngine::HealthEngine(QObject *parent)
     : QObject(parent)
     , m_sessionStartTime(QDateTime::currentDateTime())
-    , m_lastSittingBreak(QDateTime::currentDateTime())
-    , m_lastEyeBreak(QDateTime::currentDateTime())
-    , m_lastNeckExercise(QDateTime::currentDateTime())
+    , m_lastSittingBreakMs(MonotonicClock::milliseconds())
+    , m_lastEyeBreakMs(m_lastSittingBreakMs)
+    , m_lastNeckExerciseMs(m_lastSittingBreakMs)
+    , m_lastSuspendedNs(MonotonicClock::suspendedNanoseconds())
     , m_sittingTimer(new QTimer(this))
     , m_eyeRestTimer(new QTimer(this))
     , m_neckTimer(new QTimer(this))
     , m_statsTimer(new QTimer(this))
     , m_remindersPaused(false)
+    , m_pauseEndMs(0)
+    , m_fullscreenActive(false)
+    , m_suppressInFullscreen(true)
+    , m_suspendedForLock(false)
     , m_continuousSittingMinutes(0)
     , m_isCurrentlyActive(false)
 {
@@ -40,9 +53,10 @@ void HealthEngine::start()
     Logger::info("健康引擎启动", "HealthEngine");
     
     m_sessionStartTime = QDateTime::currentDateTime();
-    m_lastSittingBreak = QDateTime::currentDateTime();
-    m_lastEyeBreak = QDateTime::currentDateTime();
-    m_lastNeckExercise = QDateTime::currentDateTime();
+    m_lastSittingBreakMs = MonotonicClock::milliseconds();
+    m_lastEyeBreakMs = m_lastSittingBreakMs;
+    m_lastNeckExerciseMs = m_lastSittingBreakMs;
+    m_lastSuspendedNs = MonotonicClock::suspendedNanoseconds();
     
     // 重置统计数据
     m_todayStats = HealthStats();
@@ -59,6 +73,7 @@ void HealthEngine::stop()
 {
     Logger::info("健康引擎停止", "HealthEngine");
     
+    m_suspendedForLock = false;
     m_sittingTimer->stop();
     m_eyeRestTimer->stop();
     m_neckTimer->stop();
@@ -83,20 +98,20 @@ HealthEngine::HealthStats HealthEngine::getTodayStats() const
 
 void HealthEngine::takeBreak(ReminderType type)
 {
-    QDateTime now = QDateTime::currentDateTime();
+    const qint64 now = MonotonicClock::milliseconds();
     
     switch (type) {
     case ReminderType::SittingTooLong:
-        m_lastSittingBreak = now;
+        m_lastSittingBreakMs = now;
         m_continuousSittingMinutes = 0;
         m_todayStats.eyeBreaksTaken++;
         break;
     case ReminderType::EyeRest:
-        m_lastEyeBreak = now;
+        m_lastEyeBreakMs = now;
         m_todayStats.eyeBreaksTaken++;
         break;
     case ReminderType::NeckExercise:
-        m_lastNeckExercise = now;
+        m_lastNeckExerciseMs = now;
         m_todayStats.neckExercisesDone++;
         break;
     default:
@@ -112,16 +127,67 @@ void HealthEngine::takeBreak(ReminderType type)
 void HealthEngine::pauseReminders(int minutes)
 {
     m_remindersPaused = true;
-    m_pauseEndTime = QDateTime::currentDateTime().addSecs(minutes * 60);
+    m_pauseEndMs = MonotonicClock::milliseconds() + minutes * 60 * 1000LL;
     
     Logger::info(QString("提醒已暂停 %1 分钟").arg(minutes), "HealthEngine");
 }
 
+void HealthEngine::setSuppressInFullscreen(bool suppress)
+{
+    m_suppressInFullscreen = suppress;
+}
+
+void HealthEngine::onFullscreenChanged(bool fullscreen)
+{
+    m_fullscreenActive = fullscreen;
+    if (m_suppressInFullscreen) {
+        Logger::info(fullscreen ? "活跃窗口全屏，暂不弹出提醒" : "退出全屏，恢复提醒", "HealthEngine");
+    }
+}
+
+void HealthEngine::onScreenLockChanged(bool locked)
+{
+    if (locked) {
+        if (!m_sittingTimer->isActive()) {
+            return;
+        }
+        // 锁屏时用户已离开，期间无需每分钟唤醒检查；休息本身由 onBreakDetected 计入
+        m_suspendedForLock = true;
+        m_isCurrentlyActive = false;
+        m_sittingTimer->stop();
+        m_eyeRestTimer->stop();
+        m_neckTimer->stop();
+        m_statsTimer->stop();
+        Logger::info("屏幕已锁定，暂停健康检查", "HealthEngine");
+    } else if (m_suspendedForLock) {
+        m_suspendedForLock = false;
+        checkForResume();
+        m_sittingTimer->start();
+        m_eyeRestTimer->start();
+        m_neckTimer->start();
+        m_statsTimer->start();
+        Logger::info("屏幕已解锁，恢复健康检查", "HealthEngine");
+    }
+}
+
 void HealthEngine::onActivityDetected(const ActivityMonitor::ActivityData& data)
 {
     m_isCurrentlyActive = data.isActive;
+}
+
+void HealthEngine::onActivityBatch(const ActivityMonitor::ActivityBatch& batch)
+{
+    if (!batch.isEmpty()) {
+        m_isCurrentlyActive = batch.constLast().isActive;
+    }
+}
+
+void HealthEngine::onActivityBucket(const ActivityMonitor::ActivityBucket& bucket)
+{
+    checkForResume();
+    m_isCurrentlyActive = bucket.activeSeconds > 0;
     
-    if (data.isActive) {
+    if (bucket.activeSeconds >= kSittingMinuteThresholdSeconds) {
         m_continuousSittingMinutes++;
         m_todayStats.totalSittingMinutes++;
         
@@ -132,9 +198,66 @@ void HealthEngine::onActivityDetected(const ActivityMonitor::ActivityData& data)
     }
 }
 
+void HealthEngine::onBreakDetected(const ActivityMonitor::BreakInterval& interval)
+{
+    // 休息在确认前一个合并间隔就已结束，计时从休息结束时算起
+    const qint64 sinceEndMs = qMax<qint64>(0, MonotonicClock::currentUnixMs() - interval.endMs);
+    const qint64 breakEndMs = MonotonicClock::milliseconds() - sinceEndMs;
+    m_lastSittingBreakMs = qMax(m_lastSittingBreakMs, breakEndMs);
+    m_lastEyeBreakMs = qMax(m_lastEyeBreakMs, breakEndMs);
+    m_continuousSittingMinutes = 0;
+
+    logHealthEvent(ReminderType::SittingTooLong, "break_detected");
+    Logger::info(QString("检测到休息 %1 分钟，此前连续坐立 %2 分钟")
+                 .arg((interval.endMs - interval.startMs) / 60000)
+                 .arg(interval.sittingMs / 60000), "HealthEngine");
+}
+
+void HealthEngine::onUserBecameInactive()
+{
+    m_isCurrentlyActive = false;
+}
+
+void HealthEngine::onUserBecameActive()
+{
+    m_isCurrentlyActive = true;
+}
+
+void HealthEngine::checkForResume()
+{
+    // 单调时钟不含挂起时间；BOOTTIME 与 MONOTONIC 之差增长说明期间系统睡眠过
+    const qint64 suspendedNs = MonotonicClock::suspendedNanoseconds();
+    const qint64 sleptNs = suspendedNs - m_lastSuspendedNs;
+    m_lastSuspendedNs = suspendedNs;
+    if (sleptNs < kMinSuspendNs) {
+        return;
+    }
+
+    // 睡眠期间用户不在座位上：视为一次完整的休息，不计入坐立时间
+    MonotonicClock::resynchronize();
+    const qint64 now = MonotonicClock::milliseconds();
+    m_lastSittingBreakMs = now;
+    m_lastEyeBreakMs = now;
+    m_lastNeckExerciseMs = now;
+    m_continuousSittingMinutes = 0;
+    m_isCurrentlyActive = false;
+
+    Logger::info(QString("检测到系统从挂起中恢复（约 %1 分钟），重置坐立计时")
+                 .arg(sleptNs / (60LL * 1000 * 1000 * 1000)), "HealthEngine");
+}
+
+bool HealthEngine::remindersPaused() const
+{
+    if (m_fullscreenActive && m_suppressInFullscreen) {
+        return true;
+    }
+    return m_remindersPaused && MonotonicClock::milliseconds() < m_pauseEndMs;
+}
+
 void HealthEngine::checkSittingTime()
 {
-    if (m_remindersPaused && QDateTime::currentDateTime() < m_pauseEndTime) {
+    checkForResume();
+    if (remindersPaused()) {
         return;
     }
     
@@ -143,7 +266,7 @@ void HealthEngine::checkSittingTime()
         return;
     }
     
-    int minutesSinceLastBreak = m_lastSittingBreak.secsTo(QDateTime::currentDateTime()) / 60;
+    int minutesSinceLastBreak = static_cast<int>((MonotonicClock::milliseconds() - m_lastSittingBreakMs) / 60000);
     
     if (minutesSinceLastBreak >= config.intervalMinutes && m_isCurrentlyActive) {
         emit reminderTriggered(ReminderType::SittingTooLong, config.message, config.suggestion);
@@ -155,7 +278,8 @@ void HealthEngine::checkSittingTime()
 
 void HealthEngine::checkEyeRest()
 {
-    if (m_remindersPaused && QDateTime::currentDateTime() < m_pauseEndTime) {
+    checkForResume();
+    if (remindersPaused()) {
         return;
     }
     
@@ -164,7 +288,7 @@ void HealthEngine::checkEyeRest()
         return;
     }
     
-    int minutesSinceLastBreak = m_lastEyeBreak.secsTo(QDateTime::currentDateTime()) / 60;
+    int minutesSinceLastBreak = static_cast<int>((MonotonicClock::milliseconds() - m_lastEyeBreakMs) / 60000);
     
     if (minutesSinceLastBreak >= config.intervalMinutes && m_isCurrentlyActive) {
         emit reminderTriggered(ReminderType::EyeRest, config.message, config.suggestion);
@@ -176,7 +300,8 @@ void HealthEngine::checkEyeRest()
 
 void HealthEngine::checkNeckExercise()
 {
-    if (m_remindersPaused && QDateTime::currentDateTime() < m_pauseEndTime) {
+    checkForResume();
+    if (remindersPaused()) {
         return;
     }
     
@@ -185,7 +310,7 @@ void HealthEngine::checkNeckExercise()
         return;
     }
     
-    int minutesSinceLastExercise = m_lastNeckExercise.secsTo(QDateTime::currentDateTime()) / 60;
+    int minutesSinceLastExercise = static_cast<int>((MonotonicClock::milliseconds() - m_lastNeckExerciseMs) / 60000);
     
     if (minutesSinceLastExercise >= config.intervalMinutes && m_isCurrentlyActive) {
         emit reminderTriggered(ReminderType::NeckExercise, config.message, config.suggestion);
@@ -0,0 +1,55 @@
+#include "core/InputSource.h"
+#include "core/PollingInputSource.h"
+
+#ifdef Q_OS_LINUX
+#include "core/EvdevInputSource.h"
+#include "core/X11InputSource.h"
+#endif
+
+InputSource::InputSource(QObject *parent)
+    : QObject(parent)
+{
+}
+
+InputSource::~InputSource()
+{
+}
+
+QStringList InputSource::candidateBackends(const QString& backend)
+{
+    QString requested = backend;
+    if (requested.isEmpty()) {
+        requested = qEnvironmentVariable("WELLNESS_INPUT_BACKEND").trimmed().toLower();
+    }
+    if (!requested.isEmpty()) {
+        return QStringList() << requested;
+    }
+
+#ifdef Q_OS_LINUX
+    // Wayland 会话或无显示的终端上 X11 不可用，直接读取 evdev
+    if (qEnvironmentVariableIsEmpty("DISPLAY")) {
+        return QStringList() << "evdev";
+    }
+    return QStringList() << "x11" << "evdev";
+#else
+    return QStringList() << "polling";
+#endif
+}
+
+std::unique_ptr<InputSource> InputSource::create(const QString& backend, const QString& displayName)
+{
+#ifdef Q_OS_LINUX
+    if (backend == "x11") {
+        return std::make_unique<X11InputSource>(displayName);
+    }
+    if (backend == "evdev") {
+        return std::make_unique<EvdevInputSource>();
+    }
+#else
+    Q_UNUSED(displayName);
+#endif
+    if (backend == "polling") {
+        return std::make_unique<PollingInputSource>();
+    }
+    return nullptr;
+}
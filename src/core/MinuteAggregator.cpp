@@ -0,0 +1,124 @@
+#include "core/MinuteAggregator.h"
+#include <QtGlobal>
+
+namespace {
+
+constexpr qint64 kMinuteMs = 60 * 1000;
+constexpr qint64 kNominalSampleMs = 1000; // 首个采样或间隔异常时按 1 秒计
+
+} // namespace
+
+MinuteAggregator::MinuteAggregator()
+    : m_hasBucket(false)
+    , m_current()
+    , m_activeMilliseconds(0)
+    , m_movingMilliseconds(0)
+    , m_lastTimestampMs(0)
+    , m_windows()
+    , m_windowCount(0)
+    , m_applications()
+    , m_applicationCount(0)
+{
+}
+
+bool MinuteAggregator::add(qint64 timestampMs, bool isActive, int clickDelta, int keyDelta,
+                           double pointerDistance, int wheelDelta, const LogHistogram& keyIntervals,
+                           quint32 windowTitleId, quint32 applicationId,
+                           ActivityMonitor::ActivityBucket* completed)
+{
+    const qint64 minuteStartMs = timestampMs - (timestampMs % kMinuteMs);
+    bool finished = false;
+
+    if (m_hasBucket && minuteStartMs != m_current.minuteStartMs) {
+        finishBucket(completed);
+        finished = true;
+    }
+    if (!m_hasBucket) {
+        beginBucket(minuteStartMs);
+    }
+
+    // 采样代表自上一个采样以来的时间段；空闲退避时间隔可达 60 秒
+    qint64 elapsedMs = kNominalSampleMs;
+    if (m_lastTimestampMs > 0 && timestampMs > m_lastTimestampMs) {
+        elapsedMs = qMin(timestampMs - m_lastTimestampMs, kMinuteMs);
+    }
+    m_lastTimestampMs = timestampMs;
+
+    // 长间隔（空闲退避或暂停采样）后的首个活跃采样只说明用户刚回来，按一个标准采样计
+    if (isActive) {
+        m_activeMilliseconds += static_cast<int>(qMin(elapsedMs, kNominalSampleMs));
+    }
+    m_current.mouseClicks += qMax(0, clickDelta);
+    m_current.keystrokes += qMax(0, keyDelta);
+    m_current.wheelTicks += qMax(0, wheelDelta);
+    m_current.keyIntervals.merge(keyIntervals);
+
+    // 速度以采样间隔为粒度：峰值取单个采样区间的最大值，均值只计移动期间
+    if (pointerDistance > 0.0) {
+        m_current.pointerDistance += pointerDistance;
+        m_movingMilliseconds += static_cast<int>(elapsedMs);
+        m_current.peakVelocity = qMax(m_current.peakVelocity, pointerDistance * 1000.0 / elapsedMs);
+    }
+
+    addDwell(m_windows, m_windowCount, windowTitleId, static_cast<int>(elapsedMs));
+    addDwell(m_applications, m_applicationCount, applicationId, static_cast<int>(elapsedMs));
+    return finished;
+}
+
+bool MinuteAggregator::flush(ActivityMonitor::ActivityBucket* completed)
+{
+    if (!m_hasBucket) {
+        return false;
+    }
+    finishBucket(completed);
+    return true;
+}
+
+void MinuteAggregator::beginBucket(qint64 minuteStartMs)
+{
+    m_hasBucket = true;
+    m_current = ActivityMonitor::ActivityBucket();
+    m_current.minuteStartMs = minuteStartMs;
+    m_activeMilliseconds = 0;
+    m_movingMilliseconds = 0;
+    m_windowCount = 0;
+    m_applicationCount = 0;
+}
+
+void MinuteAggregator::finishBucket(ActivityMonitor::ActivityBucket* completed)
+{
+    m_current.activeSeconds = qMin(60, (m_activeMilliseconds + 500) / 1000);
+    if (m_movingMilliseconds > 0) {
+        m_current.meanVelocity = m_current.pointerDistance * 1000.0 / m_movingMilliseconds;
+    }
+
+    m_current.dominantWindowTitleId = dominantId(m_windows, m_windowCount);
+    m_current.dominantApplicationId = dominantId(m_applications, m_applicationCount);
+
+    *completed = m_current;
+    m_hasBucket = false;
+}
+
+void MinuteAggregator::addDwell(Dwell* dwells, int& count, quint32 id, int milliseconds)
+{
+    for (int i = 0; i < count; ++i) {
+        if (dwells[i].id == id) {
+            dwells[i].milliseconds += milliseconds;
+            return;
+        }
+    }
+    if (count < MaxTracked) {
+        dwells[count++] = {id, milliseconds};
+    }
+}
+
+quint32 MinuteAggregator::dominantId(const Dwell* dwells, int count)
+{
+    int dominant = -1;
+    for (int i = 0; i < count; ++i) {
+        if (dominant < 0 || dwells[i].milliseconds > dwells[dominant].milliseconds) {
+            dominant = i;
+        }
+    }
+    return dominant >= 0 ? dwells[dominant].id : 0;
+}
@@ -0,0 +1,131 @@
+#include "core/PollingInputSource.h"
+#include "utils/SystemUtils.h"
+#include <cmath>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <winuser.h>
+#include <shellapi.h>
+#endif
+
+PollingInputSource::PollingInputSource(QObject *parent)
+    : InputSource(parent)
+    , m_lastMouseClickTime(0)
+    , m_lastKeystrokeTime(0)
+    , m_lastCursorX(-1)
+    , m_lastCursorY(-1)
+    , m_fullscreen(false)
+{
+}
+
+PollingInputSource::~PollingInputSource()
+{
+}
+
+void PollingInputSource::poll()
+{
+    pollMouse();
+    pollKeyboard();
+    pollFullscreen();
+}
+
+void PollingInputSource::pollFullscreen()
+{
+#ifdef Q_OS_WIN
+    // 系统判定的"请勿打扰"状态：全屏程序、D3D 全屏游戏、演示模式
+    QUERY_USER_NOTIFICATION_STATE state;
+    if (FAILED(SHQueryUserNotificationState(&state))) {
+        return;
+    }
+    const bool fullscreen = state == QUNS_BUSY ||
+                            state == QUNS_RUNNING_D3D_FULL_SCREEN ||
+                            state == QUNS_PRESENTATION_MODE;
+    if (fullscreen != m_fullscreen) {
+        m_fullscreen = fullscreen;
+        emit fullscreenChanged(fullscreen);
+    }
+#endif
+}
+
+int PollingInputSource::idleMilliseconds()
+{
+#ifdef Q_OS_WIN
+    LASTINPUTINFO lastInputInfo;
+    lastInputInfo.cbSize = sizeof(LASTINPUTINFO);
+    if (GetLastInputInfo(&lastInputInfo)) {
+        return static_cast<int>(GetTickCount() - lastInputInfo.dwTime);
+    }
+#endif
+    return -1;
+}
+
+QString PollingInputSource::activeWindowTitle()
+{
+    return SystemUtils::getActiveWindowTitle();
+}
+
+qint64 PollingInputSource::activeWindowPid()
+{
+#ifdef Q_OS_WIN
+    HWND hwnd = GetForegroundWindow();
+    DWORD processId = 0;
+    if (hwnd) {
+        GetWindowThreadProcessId(hwnd, &processId);
+    }
+    return static_cast<qint64>(processId);
+#else
+    return 0;
+#endif
+}
+
+void PollingInputSource::pollMouse()
+{
+#ifdef Q_OS_WIN
+    // Windows: 两次轮询之间的光标位移（直线距离）
+    POINT cursor;
+    if (GetCursorPos(&cursor)) {
+        if (m_lastCursorX >= 0 && (cursor.x != m_lastCursorX || cursor.y != m_lastCursorY)) {
+            m_counters.motionEvents++;
+            m_counters.pointerDistance += std::hypot(cursor.x - m_lastCursorX, cursor.y - m_lastCursorY);
+        }
+        m_lastCursorX = cursor.x;
+        m_lastCursorY = cursor.y;
+    }
+
+    // Windows: 获取鼠标点击计数
+    DWORD currentTime = GetTickCount();
+    if (currentTime - m_lastMouseClickTime > 100) { // 100ms间隔检测
+        // 检查鼠标按键状态
+        if (GetAsyncKeyState(VK_LBUTTON) & 0x8000 || 
+            GetAsyncKeyState(VK_RBUTTON) & 0x8000 ||
+            GetAsyncKeyState(VK_MBUTTON) & 0x8000) {
+            m_counters.mouseClicks++;
+            m_lastMouseClickTime = currentTime;
+        }
+    }
+#else
+    // 其他平台或模拟数据
+    m_counters.mouseClicks++;
+#endif
+}
+
+void PollingInputSource::pollKeyboard()
+{
+#ifdef Q_OS_WIN
+    // Windows: 检测键盘活动
+    DWORD currentTime = GetTickCount();
+    if (currentTime - m_lastKeystrokeTime > 50) { // 50ms间隔检测
+        // 检查常用按键状态
+        for (int key = 8; key <= 255; key++) {
+            if (GetAsyncKeyState(key) & 0x8000) {
+                m_counters.addKeystroke(currentTime);
+                m_lastKeystrokeTime = currentTime;
+                break;
+            }
+        }
+    }
+#else
+    // 其他平台或模拟数据
+    m_counters.keystrokes++;
+#endif
+}
@@ -0,0 +1,125 @@
+#include "core/TraceRecorder.h"
+#include "core/TraceFormat.h"
+#include "utils/Logger.h"
+#include "utils/StringInternPool.h"
+#include <cmath>
+
+namespace {
+
+constexpr int kFlushThreshold = 64 * 1024; // 缓冲达到 64KB 时写盘
+
+} // namespace
+
+TraceRecorder::TraceRecorder()
+    : m_sampleCount(0)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    close();
+}
+
+bool TraceRecorder::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        Logger::error(QString("无法创建轨迹文件: %1").arg(filePath), "TraceRecorder");
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.append(TraceFormat::Magic, sizeof(TraceFormat::Magic));
+    m_buffer.append(static_cast<char>(TraceFormat::Version));
+    m_writtenTitles.clear();
+    m_writtenApplications.clear();
+    m_previous = ActivityCapture::Sample();
+    m_sampleCount = 0;
+
+    Logger::info(QString("开始录制活动轨迹: %1").arg(filePath), "TraceRecorder");
+    return true;
+}
+
+void TraceRecorder::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    flush();
+    m_file.close();
+    Logger::info(QString("活动轨迹录制结束，共 %1 个采样").arg(m_sampleCount), "TraceRecorder");
+}
+
+void TraceRecorder::record(const ActivityCapture::Sample& sample)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    if (sample.windowTitleId != StringInternPool::EmptyId && !m_writtenTitles.contains(sample.windowTitleId)) {
+        writeDefinition(TraceFormat::RecordTitle, sample.windowTitleId,
+                        StringInternPool::titles().resolve(sample.windowTitleId));
+        m_writtenTitles.insert(sample.windowTitleId);
+    }
+    if (sample.applicationId != StringInternPool::EmptyId && !m_writtenApplications.contains(sample.applicationId)) {
+        writeDefinition(TraceFormat::RecordApplication, sample.applicationId,
+                        StringInternPool::applications().resolve(sample.applicationId));
+        m_writtenApplications.insert(sample.applicationId);
+    }
+
+    m_buffer.append(static_cast<char>(TraceFormat::RecordSample));
+    TraceFormat::writeVarint(m_buffer, sample.timestampMs - m_previous.timestampMs);
+    TraceFormat::writeVarint(m_buffer, sample.mouseClicks - m_previous.mouseClicks);
+    TraceFormat::writeVarint(m_buffer, sample.keystrokes - m_previous.keystrokes);
+    TraceFormat::writeVarint(m_buffer, sample.motionEvents - m_previous.motionEvents);
+    TraceFormat::writeVarint(m_buffer, sample.windowTitleId);
+    // 距离按累计值取整后差分，误差不随采样数累积
+    TraceFormat::writeVarint(m_buffer, std::llround(sample.pointerDistance) - std::llround(m_previous.pointerDistance));
+    TraceFormat::writeVarint(m_buffer, sample.wheelTicks - m_previous.wheelTicks);
+    TraceFormat::writeVarint(m_buffer, sample.applicationId);
+
+    // 按键间隔分布只写有变化的桶，大多数采样只占 1 字节
+    int changedBuckets = 0;
+    for (int i = 0; i < LogHistogram::BucketCount; ++i) {
+        if (sample.keyIntervals.count(i) != m_previous.keyIntervals.count(i)) {
+            changedBuckets++;
+        }
+    }
+    TraceFormat::writeVarint(m_buffer, changedBuckets);
+    for (int i = 0; i < LogHistogram::BucketCount && changedBuckets > 0; ++i) {
+        const qint64 delta = static_cast<qint64>(sample.keyIntervals.count(i)) - m_previous.keyIntervals.count(i);
+        if (delta != 0) {
+            TraceFormat::writeVarint(m_buffer, i);
+            TraceFormat::writeVarint(m_buffer, delta);
+            changedBuckets--;
+        }
+    }
+
+    m_previous = sample;
+    m_sampleCount++;
+
+    if (m_buffer.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+void TraceRecorder::writeDefinition(TraceFormat::RecordType type, quint32 id, const QString& value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    m_buffer.append(static_cast<char>(type));
+    TraceFormat::writeVarint(m_buffer, id);
+    TraceFormat::writeVarint(m_buffer, utf8.size());
+    m_buffer.append(utf8);
+}
+
+void TraceRecorder::flush()
+{
+    if (!m_buffer.isEmpty()) {
+        m_file.write(m_buffer);
+        m_file.flush();
+        m_buffer.clear();
+    }
+}
@@ -0,0 +1,191 @@
+#include "core/TraceReplayer.h"
+#include "core/ActivityMonitor.h"
+#include "core/TraceFormat.h"
+#include "utils/Logger.h"
+#include "utils/StringInternPool.h"
+#include <QFile>
+#include <QTimer>
+#include <climits>
+
+namespace {
+
+constexpr int kMaxSpeedBatch = 4096; // 最大速度时每轮事件循环注入的采样数
+
+} // namespace
+
+TraceReplayer::TraceReplayer(ActivityMonitor* monitor, QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_timer(new QTimer(this))
+    , m_speed(1.0)
+    , m_position(0)
+    , m_version(0)
+    , m_lastInjectedMs(0)
+    , m_hasPending(false)
+    , m_replayedSamples(0)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &TraceReplayer::replayNext);
+}
+
+TraceReplayer::~TraceReplayer()
+{
+}
+
+bool TraceReplayer::open(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::error(QString("无法打开轨迹文件: %1").arg(filePath), "TraceReplayer");
+        return false;
+    }
+    m_data = file.readAll();
+
+    m_version = m_data.size() >= TraceFormat::HeaderSize
+        ? static_cast<quint8>(m_data.at(sizeof(TraceFormat::Magic))) : 0;
+    if (m_data.size() < TraceFormat::HeaderSize ||
+        !m_data.startsWith(QByteArray(TraceFormat::Magic, sizeof(TraceFormat::Magic))) ||
+        m_version < TraceFormat::MinVersion || m_version > TraceFormat::Version) {
+        Logger::error(QString("轨迹文件格式无效: %1").arg(filePath), "TraceReplayer");
+        m_data.clear();
+        return false;
+    }
+
+    m_position = TraceFormat::HeaderSize;
+    m_titleIds.clear();
+    m_applicationIds.clear();
+    m_decoded = ActivityCapture::Sample();
+    m_lastInjectedMs = 0;
+    m_hasPending = false;
+    m_replayedSamples = 0;
+    return true;
+}
+
+void TraceReplayer::setSpeed(double speed)
+{
+    m_speed = speed > 0.0 ? speed : MaxSpeed;
+}
+
+void TraceReplayer::start()
+{
+    Logger::info(QString("开始回放活动轨迹（速度 %1）")
+                 .arg(m_speed == MaxSpeed ? QString("max") : QString::number(m_speed)), "TraceReplayer");
+    m_timer->start(0);
+}
+
+void TraceReplayer::replayNext()
+{
+    // 由等待计时器唤醒时，待注入的采样已经等够了原始间隔
+    bool waited = m_hasPending;
+    int budget = kMaxSpeedBatch;
+
+    for (;;) {
+        if (!m_hasPending) {
+            if (!readSample(m_pending)) {
+                Logger::info(QString("活动轨迹回放完成，共 %1 个采样").arg(m_replayedSamples), "TraceReplayer");
+                emit finished();
+                return;
+            }
+            m_hasPending = true;
+            waited = false;
+        }
+
+        if (!waited && m_speed != MaxSpeed && m_replayedSamples > 0) {
+            const qint64 delayMs = qRound64((m_pending.timestampMs - m_lastInjectedMs) / m_speed);
+            if (delayMs > 0) {
+                m_timer->start(static_cast<int>(qMin<qint64>(delayMs, INT_MAX)));
+                return;
+            }
+        }
+
+        m_monitor->injectSample(m_pending);
+        m_lastInjectedMs = m_pending.timestampMs;
+        m_hasPending = false;
+        waited = false;
+        m_replayedSamples++;
+
+        if (--budget == 0) {
+            // 让出事件循环，保证界面与计时器仍能运行
+            m_timer->start(0);
+            return;
+        }
+    }
+}
+
+bool TraceReplayer::readKeyIntervals(LogHistogram& histogram)
+{
+    qint64 changedBuckets = 0;
+    if (!TraceFormat::readVarint(m_data, m_position, changedBuckets) || changedBuckets < 0) {
+        return false;
+    }
+    for (qint64 i = 0; i < changedBuckets; ++i) {
+        qint64 bucket = 0, delta = 0;
+        if (!TraceFormat::readVarint(m_data, m_position, bucket) ||
+            !TraceFormat::readVarint(m_data, m_position, delta) ||
+            bucket < 0 || bucket >= LogHistogram::BucketCount) {
+            return false;
+        }
+        const int index = static_cast<int>(bucket);
+        histogram.setCount(index, static_cast<quint32>(histogram.count(index) + delta));
+    }
+    return true;
+}
+
+bool TraceReplayer::readSample(ActivityCapture::Sample& sample)
+{
+    while (m_position < m_data.size()) {
+        const quint8 type = static_cast<quint8>(m_data.at(m_position++));
+
+        if (type == TraceFormat::RecordTitle || type == TraceFormat::RecordApplication) {
+            qint64 traceId = 0, length = 0;
+            if (!TraceFormat::readVarint(m_data, m_position, traceId) ||
+                !TraceFormat::readVarint(m_data, m_position, length) ||
+                length < 0 || m_position + length > m_data.size()) {
+                break;
+            }
+            const QString value = QString::fromUtf8(m_data.constData() + m_position, static_cast<int>(length));
+            m_position += static_cast<int>(length);
+            if (type == TraceFormat::RecordTitle) {
+                m_titleIds.insert(traceId, StringInternPool::titles().intern(value));
+            } else {
+                m_applicationIds.insert(traceId, StringInternPool::applications().intern(value));
+            }
+            continue;
+        }
+
+        if (type == TraceFormat::RecordSample) {
+            // 字段均为相对上一条采样的差分；版本 1 没有指针距离和滚轮字段，版本 3 起带应用程序
+            qint64 fields[8] = {};
+            const int fieldCount = m_version >= 3 ? 8 : (m_version >= 2 ? 7 : 5);
+            for (int i = 0; i < fieldCount; ++i) {
+                if (!TraceFormat::readVarint(m_data, m_position, fields[i])) {
+                    Logger::warning("轨迹文件末尾记录不完整，已忽略", "TraceReplayer");
+                    m_position = m_data.size();
+                    return false;
+                }
+            }
+            sample.timestampMs = m_decoded.timestampMs + fields[0];
+            sample.mouseClicks = m_decoded.mouseClicks + static_cast<int>(fields[1]);
+            sample.keystrokes = m_decoded.keystrokes + static_cast<int>(fields[2]);
+            sample.motionEvents = m_decoded.motionEvents + static_cast<int>(fields[3]);
+            sample.windowTitleId = m_titleIds.value(fields[4], StringInternPool::EmptyId);
+            sample.pointerDistance = m_decoded.pointerDistance + static_cast<double>(fields[5]);
+            sample.wheelTicks = m_decoded.wheelTicks + static_cast<int>(fields[6]);
+            sample.applicationId = m_applicationIds.value(fields[7], StringInternPool::EmptyId);
+            sample.keyIntervals = m_decoded.keyIntervals;
+            if (m_version >= 4 && !readKeyIntervals(sample.keyIntervals)) {
+                Logger::warning("轨迹文件末尾记录不完整，已忽略", "TraceReplayer");
+                m_position = m_data.size();
+                return false;
+            }
+            m_decoded = sample;
+            return true;
+        }
+
+        Logger::warning(QString("未知的轨迹记录类型 %1，停止回放").arg(type), "TraceReplayer");
+        break;
+    }
+
+    m_position = m_data.size();
+    return false;
+}
@@ -0,0 +1,266 @@
+#include "core/WindowTracker.h"
+#include "utils/Logger.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+#include <mutex>
+
+namespace {
+
+QMutex trackedDisplaysMutex;
+QSet<Display*> trackedDisplays;        // 由 WindowTracker 使用的 X 连接
+XErrorHandler previousErrorHandler = nullptr;
+std::once_flag errorHandlerInstalled;
+
+// 被跟踪的窗口随时可能销毁，忽略跟踪连接上由此产生的 BadWindow 等异步错误，
+// 否则 Xlib 默认错误处理会直接退出进程；其他连接的错误交给原来的处理函数
+int handleXError(Display* display, XErrorEvent* error)
+{
+    bool tracked;
+    {
+        QMutexLocker locker(&trackedDisplaysMutex);
+        tracked = trackedDisplays.contains(display);
+    }
+    if (!tracked) {
+        return previousErrorHandler ? previousErrorHandler(display, error) : 0;
+    }
+    Logger::debug(QString("忽略 X 错误: code=%1 request=%2")
+                  .arg(error->error_code).arg(error->request_code), "WindowTracker");
+    return 0;
+}
+
+} // namespace
+
+void WindowTracker::installErrorHandler()
+{
+    // Xlib 错误处理函数是进程级的，只安装一次
+    std::call_once(errorHandlerInstalled, []() {
+        previousErrorHandler = XSetErrorHandler(handleXError);
+    });
+}
+
+WindowTracker::WindowTracker(Display* display)
+    : m_display(display)
+    , m_root(DefaultRootWindow(display))
+    , m_activeWindow(None)
+    , m_activeFullscreen(false)
+    , m_activePid(0)
+    , m_eventDriven(false)
+{
+    installErrorHandler();
+    {
+        QMutexLocker locker(&trackedDisplaysMutex);
+        trackedDisplays.insert(m_display);
+    }
+
+    m_netActiveWindowAtom = XInternAtom(m_display, "_NET_ACTIVE_WINDOW", False);
+    m_netWmNameAtom = XInternAtom(m_display, "_NET_WM_NAME", False);
+    m_utf8StringAtom = XInternAtom(m_display, "UTF8_STRING", False);
+    m_netWmStateAtom = XInternAtom(m_display, "_NET_WM_STATE", False);
+    m_netWmStateFullscreenAtom = XInternAtom(m_display, "_NET_WM_STATE_FULLSCREEN", False);
+    m_netWmPidAtom = XInternAtom(m_display, "_NET_WM_PID", False);
+
+    // 根窗口上的 _NET_ACTIVE_WINDOW 变化会以 PropertyNotify 通知
+    XSelectInput(m_display, m_root, PropertyChangeMask);
+
+    bool supported = false;
+    unsigned long window = queryActiveWindow(&supported);
+    m_eventDriven = supported;
+    setActiveWindow(window);
+
+    if (!m_eventDriven) {
+        Logger::warning("窗口管理器不支持 _NET_ACTIVE_WINDOW，改为按需查询焦点窗口", "WindowTracker");
+    }
+}
+
+WindowTracker::~WindowTracker()
+{
+    if (m_activeWindow != None) {
+        XSelectInput(m_display, m_activeWindow, NoEventMask);
+    }
+    XSelectInput(m_display, m_root, NoEventMask);
+
+    // 取消选择前产生的错误须在注销前处理完
+    XSync(m_display, False);
+    QMutexLocker locker(&trackedDisplaysMutex);
+    trackedDisplays.remove(m_display);
+}
+
+bool WindowTracker::handleEvent(const XEvent& event)
+{
+    if (event.type != PropertyNotify) {
+        return false;
+    }
+
+    const XPropertyEvent& property = event.xproperty;
+    if (property.window == m_root && property.atom == m_netActiveWindowAtom) {
+        bool supported = false;
+        setActiveWindow(queryActiveWindow(&supported));
+        return true;
+    }
+
+    if (property.window == m_activeWindow &&
+        (property.atom == m_netWmNameAtom || property.atom == XA_WM_NAME)) {
+        m_activeTitle = fetchTitle(m_activeWindow);
+        return true;
+    }
+
+    if (property.window == m_activeWindow && property.atom == m_netWmStateAtom) {
+        m_activeFullscreen = fetchFullscreen(m_activeWindow);
+        return true;
+    }
+
+    return false;
+}
+
+void WindowTracker::refresh()
+{
+    bool supported = false;
+    setActiveWindow(queryActiveWindow(&supported));
+    m_activeTitle = fetchTitle(m_activeWindow);
+    m_activeFullscreen = fetchFullscreen(m_activeWindow);
+}
+
+unsigned long WindowTracker::queryActiveWindow(bool* supported) const
+{
+    Atom actualType;
+    int actualFormat;
+    unsigned long itemCount, bytesAfter;
+    unsigned char* prop = nullptr;
+
+    Window window = None;
+    if (XGetWindowProperty(m_display, m_root, m_netActiveWindowAtom, 0, 1, False, XA_WINDOW,
+                           &actualType, &actualFormat, &itemCount, &bytesAfter, &prop) == Success &&
+        prop) {
+        if (actualType == XA_WINDOW && actualFormat == 32 && itemCount == 1) {
+            window = *reinterpret_cast<Window*>(prop);
+            *supported = true;
+        }
+        XFree(prop);
+    }
+
+    if (!*supported) {
+        // 非 EWMH 窗口管理器：退回到输入焦点
+        int revert;
+        XGetInputFocus(m_display, &window, &revert);
+        if (window == PointerRoot) {
+            window = None;
+        }
+    }
+    return window;
+}
+
+QString WindowTracker::fetchTitle(unsigned long window) const
+{
+    if (window == None) {
+        return QString();
+    }
+
+    Atom actualType;
+    int actualFormat;
+    unsigned long itemCount, bytesAfter;
+    unsigned char* prop = nullptr;
+
+    if (XGetWindowProperty(m_display, window, m_netWmNameAtom, 0, 1024, False, m_utf8StringAtom,
+                           &actualType, &actualFormat, &itemCount, &bytesAfter, &prop) == Success &&
+        prop) {
+        QString title;
+        if (actualType == m_utf8StringAtom && actualFormat == 8) {
+            title = QString::fromUtf8(reinterpret_cast<const char*>(prop), static_cast<int>(itemCount));
+        }
+        XFree(prop);
+        if (!title.isEmpty()) {
+            return title;
+        }
+    }
+
+    // 旧式客户端只设置 WM_NAME
+    char* windowName = nullptr;
+    if (XFetchName(m_display, window, &windowName) && windowName) {
+        QString result = QString::fromLocal8Bit(windowName);
+        XFree(windowName);
+        return result;
+    }
+    return QString();
+}
+
+bool WindowTracker::fetchFullscreen(unsigned long window) const
+{
+    if (window == None) {
+        return false;
+    }
+
+    Atom actualType;
+    int actualFormat;
+    unsigned long itemCount, bytesAfter;
+    unsigned char* prop = nullptr;
+
+    bool fullscreen = false;
+    if (XGetWindowProperty(m_display, window, m_netWmStateAtom, 0, 64, False, XA_ATOM,
+                           &actualType, &actualFormat, &itemCount, &bytesAfter, &prop) == Success &&
+        prop) {
+        if (actualType == XA_ATOM && actualFormat == 32) {
+            const Atom* states = reinterpret_cast<const Atom*>(prop);
+            for (unsigned long i = 0; i < itemCount; ++i) {
+                if (states[i] == m_netWmStateFullscreenAtom) {
+                    fullscreen = true;
+                    break;
+                }
+            }
+        }
+        XFree(prop);
+    }
+    return fullscreen;
+}
+
+qint64 WindowTracker::fetchPid(unsigned long window) const
+{
+    if (window == None) {
+        return 0;
+    }
+
+    Atom actualType;
+    int actualFormat;
+    unsigned long itemCount, bytesAfter;
+    unsigned char* prop = nullptr;
+
+    qint64 pid = 0;
+    if (XGetWindowProperty(m_display, window, m_netWmPidAtom, 0, 1, False, XA_CARDINAL,
+                           &actualType, &actualFormat, &itemCount, &bytesAfter, &prop) == Success &&
+        prop) {
+        if (actualType == XA_CARDINAL && actualFormat == 32 && itemCount == 1) {
+            pid = static_cast<qint64>(*reinterpret_cast<unsigned long*>(prop));
+        }
+        XFree(prop);
+    }
+    return pid;
+}
+
+void WindowTracker::setActiveWindow(unsigned long window)
+{
+    if (window == m_activeWindow) {
+        return;
+    }
+
+    // 只关注当前活跃窗口的标题变化
+    if (m_activeWindow != None) {
+        XSelectInput(m_display, m_activeWindow, NoEventMask);
+    }
+    m_activeWindow = window;
+    if (m_activeWindow != None) {
+        XSelectInput(m_display, m_activeWindow, PropertyChangeMask);
+    }
+    XFlush(m_display);
+
+    m_activeTitle = fetchTitle(m_activeWindow);
+    m_activeFullscreen = fetchFullscreen(m_activeWindow);
+    m_activePid = fetchPid(m_activeWindow);
+}
+
+#endif // Q_OS_LINUX
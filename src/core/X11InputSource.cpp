@@ -0,0 +1,536 @@
+#include "core/X11InputSource.h"
+#include "core/WindowTracker.h"
+#include "utils/KeymapDiff.h"
+#include "utils/Logger.h"
+#include "utils/MonotonicClock.h"
+#include <QHash>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <cmath>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+#include <X11/extensions/sync.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/Xutil.h>
+
+namespace {
+
+// 轮询模式：按键通常按下 50-100 ms，20 Hz 足以捕获连续输入中的每次按键
+constexpr int kFastPollIntervalMs = 50;
+constexpr int kSlowPollIntervalMs = 1000;
+constexpr int kIdlePollsBeforeSlowdown = 20 * 1000 / kFastPollIntervalMs; // 20 秒无输入后降频
+
+} // namespace
+
+class X11InputSource::Private
+{
+public:
+    QString displayName;
+    Display* display = nullptr;
+    XScreenSaverInfo* screenSaverInfo = nullptr;
+
+    // XInput2 原始事件，xiOpcode 为 -1 时退回轮询
+    int xiOpcode = -1;
+    QSocketNotifier* notifier = nullptr;
+
+    // XSync IDLETIME 计数器上的一对报警：越过阈值变为空闲 / 回落到阈值以下恢复活跃
+    int syncEventBase = -1;
+    XSyncCounter idleCounter = None;
+    XSyncAlarm idleAlarm = None;
+    XSyncAlarm activeAlarm = None;
+
+    // 源设备 ID -> 是否相对移动设备；绝对坐标设备（数位板、触摸屏）的坐标不是像素增量
+    QHash<int, bool> relativeDevices;
+
+    // 轮询模式的状态：上一次的按键位图、按钮掩码和指针位置
+    QTimer* pollTimer = nullptr;
+    unsigned char previousKeymap[KeymapDiff::Bytes] = {};
+    unsigned int previousButtons = 0;
+    int previousX = -1;
+    int previousY = -1;
+    int idlePolls = 0;
+
+    Counters counters;
+
+    // MIT-SCREEN-SAVER 事件基址，-1 表示不支持；屏保启动或锁屏期间停止一切轮询
+    int screenSaverEventBase = -1;
+    bool screenLocked = false;
+
+    // 活跃窗口标题与全屏状态缓存
+    std::unique_ptr<WindowTracker> windowTracker;
+    bool fullscreen = false;
+
+    void accumulateMotion(const XIRawEvent* raw);
+    bool isRelativeDevice(int deviceId);
+    XSyncAlarm armAlarm(XSyncAlarm alarm, XSyncTestType testType, int thresholdMs);
+};
+
+XSyncAlarm X11InputSource::Private::armAlarm(XSyncAlarm alarm, XSyncTestType testType, int thresholdMs)
+{
+    XSyncAlarmAttributes attributes;
+    attributes.trigger.counter = idleCounter;
+    attributes.trigger.value_type = XSyncAbsolute;
+    attributes.trigger.test_type = testType;
+    XSyncIntToValue(&attributes.trigger.wait_value, thresholdMs);
+    XSyncIntToValue(&attributes.delta, 0); // delta 为 0：触发后保持激活，每次越过阈值都会通知
+    attributes.events = True;
+
+    const unsigned long mask = XSyncCACounter | XSyncCAValueType | XSyncCATestType
+                             | XSyncCAValue | XSyncCADelta | XSyncCAEvents;
+    if (alarm == None) {
+        return XSyncCreateAlarm(display, mask, &attributes);
+    }
+    XSyncChangeAlarm(display, alarm, mask, &attributes);
+    return alarm;
+}
+
+void X11InputSource::Private::accumulateMotion(const XIRawEvent* raw)
+{
+    // valuators.values 只包含掩码中置位的轴，按轴号递增排列；0/1 轴为 X/Y
+    double delta[2] = {0.0, 0.0};
+    const double* value = raw->valuators.values;
+    for (int axis = 0; axis < 2 && axis < raw->valuators.mask_len * 8; ++axis) {
+        if (XIMaskIsSet(raw->valuators.mask, axis)) {
+            delta[axis] = *value++;
+        }
+    }
+    if ((delta[0] != 0.0 || delta[1] != 0.0) && isRelativeDevice(raw->sourceid)) {
+        counters.pointerDistance += std::hypot(delta[0], delta[1]);
+    }
+}
+
+bool X11InputSource::Private::isRelativeDevice(int deviceId)
+{
+    auto it = relativeDevices.constFind(deviceId);
+    if (it != relativeDevices.constEnd()) {
+        return it.value();
+    }
+
+    // 每个设备只查询一次
+    bool relative = false;
+    int count = 0;
+    XIDeviceInfo* info = XIQueryDevice(display, deviceId, &count);
+    if (info) {
+        for (int i = 0; i < info->num_classes; ++i) {
+            const XIAnyClassInfo* any = info->classes[i];
+            if (any->type == XIValuatorClass) {
+                const XIValuatorClassInfo* valuator = reinterpret_cast<const XIValuatorClassInfo*>(any);
+                if (valuator->number == 0) {
+                    relative = valuator->mode == XIModeRelative;
+                    break;
+                }
+            }
+        }
+        XIFreeDeviceInfo(info);
+    }
+    relativeDevices.insert(deviceId, relative);
+    return relative;
+}
+
+X11InputSource::X11InputSource(const QString& displayName, QObject *parent)
+    : InputSource(parent)
+    , d(std::make_unique<Private>())
+{
+    d->displayName = displayName;
+}
+
+X11InputSource::~X11InputSource()
+{
+    close();
+}
+
+bool X11InputSource::open()
+{
+    const QByteArray name = d->displayName.toLocal8Bit();
+    d->display = XOpenDisplay(name.isEmpty() ? nullptr : name.constData());
+    if (!d->display) {
+        Logger::warning(QString("无法连接 X 服务器 %1").arg(d->displayName), "X11InputSource");
+        return false;
+    }
+
+    d->screenSaverInfo = XScreenSaverAllocInfo();
+    d->windowTracker = std::make_unique<WindowTracker>(d->display);
+    d->fullscreen = d->windowTracker->isActiveWindowFullscreen();
+    initializeRawInput();
+    initializeIdleCounter();
+    initializeScreenSaverNotify();
+
+    // X 连接可读时才唤醒，用户空闲时不产生额外开销
+    d->notifier = new QSocketNotifier(ConnectionNumber(d->display), QSocketNotifier::Read, this);
+    connect(d->notifier, &QSocketNotifier::activated, this, &X11InputSource::processPendingEvents);
+
+    if (d->xiOpcode < 0) {
+        d->pollTimer = new QTimer(this);
+        connect(d->pollTimer, &QTimer::timeout, this, &X11InputSource::pollInput);
+        if (!d->screenLocked) {
+            d->pollTimer->start(kFastPollIntervalMs);
+        }
+        Logger::info(QString("按键位图轮询使用 %1 实现").arg(KeymapDiff::implementation()), "X11InputSource");
+    }
+    return true;
+}
+
+void X11InputSource::close()
+{
+    delete d->notifier;
+    d->notifier = nullptr;
+    delete d->pollTimer;
+    d->pollTimer = nullptr;
+    d->windowTracker.reset();
+
+    if (d->display) {
+        if (d->idleAlarm != None) {
+            XSyncDestroyAlarm(d->display, d->idleAlarm);
+            d->idleAlarm = None;
+        }
+        if (d->activeAlarm != None) {
+            XSyncDestroyAlarm(d->display, d->activeAlarm);
+            d->activeAlarm = None;
+        }
+        d->idleCounter = None;
+        if (d->screenSaverEventBase >= 0) {
+            XScreenSaverSelectInput(d->display, DefaultRootWindow(d->display), 0);
+            d->screenSaverEventBase = -1;
+        }
+        d->screenLocked = false;
+        if (d->screenSaverInfo) {
+            XFree(d->screenSaverInfo);
+            d->screenSaverInfo = nullptr;
+        }
+        XCloseDisplay(d->display);
+        d->display = nullptr;
+    }
+}
+
+bool X11InputSource::isEventDriven() const
+{
+    return d->xiOpcode >= 0;
+}
+
+void X11InputSource::initializeRawInput()
+{
+    int event, error;
+    if (!XQueryExtension(d->display, "XInputExtension", &d->xiOpcode, &event, &error)) {
+        Logger::warning("X 服务器不支持 XInput 扩展，退回轮询模式", "X11InputSource");
+        d->xiOpcode = -1;
+        return;
+    }
+
+    int major = 2, minor = 2;
+    if (XIQueryVersion(d->display, &major, &minor) != Success || major < 2) {
+        Logger::warning("XInput2 不可用，退回轮询模式", "X11InputSource");
+        d->xiOpcode = -1;
+        return;
+    }
+
+    // 在根窗口订阅原始事件，只监听主设备以免重复计数
+    unsigned char maskBits[XIMaskLen(XI_LASTEVENT)] = {0};
+    XISetMask(maskBits, XI_RawKeyPress);
+    XISetMask(maskBits, XI_RawButtonPress);
+    XISetMask(maskBits, XI_RawMotion);
+
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(maskBits);
+    mask.mask = maskBits;
+    XISelectEvents(d->display, DefaultRootWindow(d->display), &mask, 1);
+    XFlush(d->display);
+
+    Logger::info(QString("已启用 XInput2 原始事件 (%1.%2)").arg(major).arg(minor), "X11InputSource");
+}
+
+void X11InputSource::initializeIdleCounter()
+{
+    int event, error, major, minor;
+    if (!XSyncQueryExtension(d->display, &event, &error) || !XSyncInitialize(d->display, &major, &minor)) {
+        Logger::warning("X 服务器不支持 XSync 扩展，空闲检测退回轮询", "X11InputSource");
+        return;
+    }
+
+    int count = 0;
+    XSyncSystemCounter* counters = XSyncListSystemCounters(d->display, &count);
+    for (int i = 0; i < count; ++i) {
+        if (qstrcmp(counters[i].name, "IDLETIME") == 0) {
+            d->idleCounter = counters[i].counter;
+            break;
+        }
+    }
+    if (counters) {
+        XSyncFreeSystemCounterList(counters);
+    }
+
+    if (d->idleCounter == None) {
+        Logger::warning("X 服务器没有 IDLETIME 计数器，空闲检测退回轮询", "X11InputSource");
+        return;
+    }
+    d->syncEventBase = event;
+}
+
+void X11InputSource::initializeScreenSaverNotify()
+{
+    int event, error;
+    if (!XScreenSaverQueryExtension(d->display, &event, &error)) {
+        Logger::warning("X 服务器不支持 MIT-SCREEN-SAVER 扩展，无法感知锁屏", "X11InputSource");
+        return;
+    }
+    d->screenSaverEventBase = event;
+    XScreenSaverSelectInput(d->display, DefaultRootWindow(d->display), ScreenSaverNotifyMask);
+
+    // 启动时屏保可能已在运行（例如在锁定的会话中重新启动）
+    if (XScreenSaverQueryInfo(d->display, DefaultRootWindow(d->display), d->screenSaverInfo)) {
+        d->screenLocked = d->screenSaverInfo->state == ScreenSaverOn;
+    }
+}
+
+bool X11InputSource::setIdleThreshold(int thresholdMs)
+{
+    if (!d->display || d->idleCounter == None || thresholdMs <= 0) {
+        return false;
+    }
+
+    // 空闲时间由小于阈值增长到阈值时触发空闲；输入使其从阈值以上回落时触发活跃
+    d->idleAlarm = d->armAlarm(d->idleAlarm, XSyncPositiveTransition, thresholdMs);
+    d->activeAlarm = d->armAlarm(d->activeAlarm, XSyncNegativeTransition, thresholdMs);
+    XFlush(d->display);
+
+    Logger::info(QString("已启用 XSync 空闲报警，阈值 %1 ms").arg(thresholdMs), "X11InputSource");
+    return d->idleAlarm != None && d->activeAlarm != None;
+}
+
+void X11InputSource::poll()
+{
+    // 先处理 Xlib 队列中已缓存的事件，避免漏计；轮询模式的计数由 pollTimer 独立完成
+    processPendingEvents();
+}
+
+InputSource::Counters X11InputSource::counters() const
+{
+    return d->counters;
+}
+
+int X11InputSource::idleMilliseconds()
+{
+    // 复用已分配的 XScreenSaverInfo 与现有连接
+    if (!d->display || !d->screenSaverInfo) return -1;
+    if (!XScreenSaverQueryInfo(d->display, DefaultRootWindow(d->display), d->screenSaverInfo)) {
+        return -1;
+    }
+    return static_cast<int>(d->screenSaverInfo->idle);
+}
+
+bool X11InputSource::isActiveWindowFullscreen() const
+{
+    return d->fullscreen;
+}
+
+bool X11InputSource::isScreenLocked() const
+{
+    return d->screenLocked;
+}
+
+void X11InputSource::updateFullscreenState()
+{
+    const bool fullscreen = d->windowTracker && d->windowTracker->isActiveWindowFullscreen();
+    if (fullscreen != d->fullscreen) {
+        d->fullscreen = fullscreen;
+        emit fullscreenChanged(fullscreen);
+    }
+}
+
+QString X11InputSource::activeWindowTitle()
+{
+    // 复用已有连接上的缓存标题，避免每次采样重新建立 X 连接
+    if (!d->windowTracker) {
+        return QString();
+    }
+    if (!d->windowTracker->isEventDriven()) {
+        d->windowTracker->refresh();
+        updateFullscreenState();
+    }
+    return d->windowTracker->activeWindowTitle();
+}
+
+qint64 X11InputSource::activeWindowPid()
+{
+    // 与标题一同缓存，采样时先调用 activeWindowTitle() 完成刷新
+    return d->windowTracker ? d->windowTracker->activeWindowPid() : 0;
+}
+
+void X11InputSource::processPendingEvents()
+{
+    if (!d->display) return;
+
+    bool sawInput = false;
+    while (XPending(d->display) > 0) {
+        XEvent event;
+        XNextEvent(d->display, &event);
+
+        if (d->windowTracker && d->windowTracker->handleEvent(event)) {
+            updateFullscreenState();
+            continue;
+        }
+
+        if (d->syncEventBase >= 0 && event.type == d->syncEventBase + XSyncAlarmNotify) {
+            handleAlarm(reinterpret_cast<const XSyncAlarmNotifyEvent&>(event).alarm);
+            continue;
+        }
+
+        if (d->screenSaverEventBase >= 0 && event.type == d->screenSaverEventBase + ScreenSaverNotify) {
+            handleScreenSaverNotify(reinterpret_cast<const XScreenSaverNotifyEvent&>(event).state);
+            continue;
+        }
+
+        XGenericEventCookie* cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != d->xiOpcode) {
+            continue;
+        }
+        if (!XGetEventData(d->display, cookie)) {
+            continue;
+        }
+
+        const XIRawEvent* raw = static_cast<const XIRawEvent*>(cookie->data);
+        sawInput = true;
+        switch (cookie->evtype) {
+        case XI_RawKeyPress:
+            if (!(raw->flags & XIKeyRepeat)) {
+                // 服务器时间戳（毫秒）反映真实按键时刻，不受事件批量处理延迟影响
+                d->counters.addKeystroke(static_cast<qint64>(raw->time));
+            }
+            break;
+        case XI_RawButtonPress:
+            // 按键 4-7 是滚轮，不计为点击
+            if (raw->detail >= 1 && raw->detail <= 3) {
+                d->counters.mouseClicks++;
+            } else if (raw->detail >= 4 && raw->detail <= 7) {
+                d->counters.wheelTicks++;
+            }
+            break;
+        case XI_RawMotion:
+            d->counters.motionEvents++;
+            d->accumulateMotion(raw);
+            break;
+        default:
+            break;
+        }
+        XFreeEventData(d->display, cookie);
+    }
+
+    if (sawInput) {
+        emit inputReceived();
+    }
+}
+
+void X11InputSource::handleAlarm(unsigned long alarm)
+{
+    if (alarm == d->idleAlarm) {
+        // 空闲期间停止轮询计时器，由活跃报警唤醒
+        if (d->pollTimer) {
+            d->pollTimer->stop();
+        }
+        emit idleStateChanged(true);
+    } else if (alarm == d->activeAlarm) {
+        // 锁屏期间输入密码也会触发活跃报警，解锁前保持轮询停止
+        if (d->pollTimer && !d->pollTimer->isActive() && !d->screenLocked) {
+            d->idlePolls = 0;
+            d->pollTimer->start(kFastPollIntervalMs);
+        }
+        emit idleStateChanged(false);
+    }
+}
+
+void X11InputSource::handleScreenSaverNotify(int state)
+{
+    // ScreenSaverCycle 只是屏保切换画面
+    if (state != ScreenSaverOn && state != ScreenSaverOff) {
+        return;
+    }
+    const bool locked = state == ScreenSaverOn;
+    if (locked == d->screenLocked) {
+        return;
+    }
+    d->screenLocked = locked;
+
+    if (d->pollTimer) {
+        if (locked) {
+            d->pollTimer->stop();
+        } else {
+            d->idlePolls = 0;
+            d->pollTimer->start(kFastPollIntervalMs);
+        }
+    }
+    Logger::info(locked ? "屏保已启动或屏幕已锁定" : "屏幕已解锁", "X11InputSource");
+    emit screenLockChanged(locked);
+}
+
+void X11InputSource::pollInput()
+{
+    if (!d->display) return;
+
+    const int newInput = pollPointer() + pollKeymap();
+    if (newInput > 0) {
+        d->idlePolls = 0;
+        if (d->pollTimer->interval() != kFastPollIntervalMs) {
+            d->pollTimer->setInterval(kFastPollIntervalMs);
+        }
+        emit inputReceived();
+    } else if (++d->idlePolls == kIdlePollsBeforeSlowdown) {
+        d->pollTimer->setInterval(kSlowPollIntervalMs);
+    }
+}
+
+int X11InputSource::pollPointer()
+{
+    Window root, child;
+    int root_x, root_y, win_x, win_y;
+    unsigned int mask;
+    
+    if (!XQueryPointer(d->display, DefaultRootWindow(d->display),
+                       &root, &child, &root_x, &root_y, &win_x, &win_y, &mask)) {
+        return 0;
+    }
+
+    int events = 0;
+
+    // 只统计新按下的按钮，按住不放不重复计数
+    const unsigned int buttons = mask & (Button1Mask | Button2Mask | Button3Mask);
+    const unsigned int pressed = buttons & ~d->previousButtons;
+    d->previousButtons = buttons;
+    for (unsigned int bit = Button1Mask; bit <= Button3Mask; bit <<= 1) {
+        if (pressed & bit) {
+            d->counters.mouseClicks++;
+            events++;
+        }
+    }
+
+    if (d->previousX >= 0 && (root_x != d->previousX || root_y != d->previousY)) {
+        d->counters.motionEvents++;
+        d->counters.pointerDistance += std::hypot(root_x - d->previousX, root_y - d->previousY);
+        events++;
+    }
+    d->previousX = root_x;
+    d->previousY = root_y;
+    return events;
+}
+
+int X11InputSource::pollKeymap()
+{
+    char keys[KeymapDiff::Bytes];
+    XQueryKeymap(d->display, keys);
+
+    // 新按下的键 = 当前位图 & ~上一次位图，按住不放与自动重复都不计数
+    const unsigned char* current = reinterpret_cast<const unsigned char*>(keys);
+    const int pressed = KeymapDiff::countNewlyPressed(d->previousKeymap, current);
+    std::memcpy(d->previousKeymap, current, KeymapDiff::Bytes);
+
+    if (pressed > 0) {
+        // 轮询粒度内无法区分先后，同一次轮询的按键只记录一个间隔
+        d->counters.addKeystroke(MonotonicClock::milliseconds());
+        d->counters.keystrokes += pressed - 1;
+    }
+    return pressed;
+}
+
+#endif // Q_OS_LINUX
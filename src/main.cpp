@@ -1,17 +1,214 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QStandardPaths>
 #include <QSystemTrayIcon>
 #include <QMessageBox>
 #include <QTimer>
 #include <iostream> // Added for std::cerr
+#include <memory>
+#include <vector>
 
 #include "ui/SystemTrayIcon.h"
+#include "core/ActivityJournal.h"
 #include "core/ActivityMonitor.h"
 #include "core/HealthEngine.h"
 #include "core/ConfigManager.h"
 #include "core/DataAnalyzer.h"
+#include "core/TraceRecorder.h"
+#include "core/TraceReplayer.h"
 #include "utils/Logger.h"
+#include "utils/StorageWriter.h"
 #include "utils/SystemUtils.h"
 
+#ifdef Q_OS_LINUX
+#include "core/WindowTracker.h"
+#endif
+
+// 活动监测 -> 健康引擎 / 数据分析，实时运行与轨迹回放共用
+static void connectActivityPipeline(ActivityMonitor& activityMonitor,
+                                    HealthEngine& healthEngine,
+                                    DataAnalyzer& dataAnalyzer)
+{
+    // 连接信号槽 - 活动监测 -> 健康引擎（每分钟聚合）
+    QObject::connect(&activityMonitor, &ActivityMonitor::activityBucketReady,
+                     &healthEngine, &HealthEngine::onActivityBucket);
+
+    // 连接信号槽 - 活动监测 -> 数据分析（每分钟聚合）
+    QObject::connect(&activityMonitor, &ActivityMonitor::activityBucketReady,
+                     &dataAnalyzer, &DataAnalyzer::recordActivityBucket);
+
+    // 焦点区间只在切换窗口时发出
+    QObject::connect(&activityMonitor, &ActivityMonitor::focusIntervalReady,
+                     &dataAnalyzer, &DataAnalyzer::recordFocusInterval);
+
+    // 逐秒数据仅在高精度模式下发出，按批接收
+    QObject::connect(&activityMonitor, &ActivityMonitor::activityBatchReady,
+                     &healthEngine, &HealthEngine::onActivityBatch);
+    QObject::connect(&activityMonitor, &ActivityMonitor::activityBatchReady,
+                     &dataAnalyzer, &DataAnalyzer::recordActivityBatch);
+
+    // 空闲期间采样暂停，由状态切换通知健康引擎
+    QObject::connect(&activityMonitor, &ActivityMonitor::userBecameInactive,
+                     &healthEngine, &HealthEngine::onUserBecameInactive);
+    QObject::connect(&activityMonitor, &ActivityMonitor::userBecameActive,
+                     &healthEngine, &HealthEngine::onUserBecameActive);
+
+    // 检测到的休息：重置坐立计时并计入日报
+    QObject::connect(&activityMonitor, &ActivityMonitor::breakDetected,
+                     &healthEngine, &HealthEngine::onBreakDetected);
+    QObject::connect(&activityMonitor, &ActivityMonitor::breakDetected,
+                     &dataAnalyzer, &DataAnalyzer::recordBreak);
+
+    // 全屏演示、视频期间暂不弹出提醒
+    QObject::connect(&activityMonitor, &ActivityMonitor::fullscreenChanged,
+                     &healthEngine, &HealthEngine::onFullscreenChanged);
+
+    // 锁屏期间暂停健康检查与定期保存
+    QObject::connect(&activityMonitor, &ActivityMonitor::screenLockChanged,
+                     &healthEngine, &HealthEngine::onScreenLockChanged);
+    QObject::connect(&activityMonitor, &ActivityMonitor::screenLockChanged,
+                     &dataAnalyzer, &DataAnalyzer::onScreenLockChanged);
+}
+
+// 将配置应用到一组活动监测 / 健康引擎
+static void applyConfig(const ConfigManager& configManager,
+                        ActivityMonitor& activityMonitor,
+                        HealthEngine& healthEngine,
+                        DataAnalyzer& dataAnalyzer)
+{
+    auto reminderTypes = {
+        HealthEngine::ReminderType::SittingTooLong,
+        HealthEngine::ReminderType::EyeRest,
+        HealthEngine::ReminderType::NeckExercise,
+        HealthEngine::ReminderType::PostureCheck,
+        HealthEngine::ReminderType::Hydration
+    };
+
+    for (auto type : reminderTypes) {
+        auto config = configManager.getReminderConfig(type);
+        healthEngine.configureReminder(type, config);
+    }
+
+    healthEngine.setSuppressInFullscreen(configManager.getGeneralConfig().suppressInFullscreen);
+
+    const ConfigManager::AdvancedConfig advanced = configManager.getAdvancedConfig();
+    activityMonitor.setHighResolutionMode(advanced.highResolutionCapture);
+    activityMonitor.setIdleThreshold(advanced.idleThresholdSeconds * 1000);
+    activityMonitor.setBreakThresholds(advanced.minBreakSeconds * 1000LL, advanced.breakMergeGapSeconds * 1000LL);
+    dataAnalyzer.setCommitInterval(advanced.journalCommitSeconds * 1000);
+    dataAnalyzer.setRetention(advanced.rawRetentionDays, advanced.dataRetentionDays);
+}
+
+// 多显示器模式：一个进程监测多个 X 显示（终端服务器），无系统托盘
+// 每个显示有独立的 X 连接与采集线程、健康引擎和数据文件，数据文件由共享写入器写盘
+static int runMultiDisplay(QApplication& app, const QStringList& displays)
+{
+    ConfigManager configManager;
+    if (!configManager.load()) {
+        Logger::warning("配置文件加载失败，使用默认配置");
+    }
+
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if (dataDir.isEmpty() || !QDir().mkpath(dataDir)) {
+        std::cerr << "Could not create data directory" << std::endl;
+        return -1;
+    }
+
+    struct DisplaySession {
+        std::unique_ptr<ActivityMonitor> activityMonitor;
+        std::unique_ptr<HealthEngine> healthEngine;
+        std::unique_ptr<DataAnalyzer> dataAnalyzer;
+    };
+
+    // 写入器须比所有数据分析实例存活更久，析构时等待最后一次保存落盘
+    StorageWriter storageWriter;
+    std::vector<DisplaySession> sessions;
+    sessions.reserve(displays.size());
+
+    for (const QString& display : displays) {
+        // ":10" -> activity_log_10.journal，"host:10.0" -> activity_log_host_10_0.journal
+        QString fileTag = display;
+        fileTag.replace(QRegularExpression("[^A-Za-z0-9]+"), "_");
+        fileTag.remove(QRegularExpression("^_+|_+$"));
+
+        DisplaySession session;
+        session.activityMonitor = std::make_unique<ActivityMonitor>();
+        session.healthEngine = std::make_unique<HealthEngine>();
+        session.dataAnalyzer = std::make_unique<DataAnalyzer>(QString("%1/activity_log_%2.json").arg(dataDir, fileTag));
+        session.activityMonitor->setDisplayName(display);
+        session.dataAnalyzer->setStorageWriter(&storageWriter);
+
+        connectActivityPipeline(*session.activityMonitor, *session.healthEngine, *session.dataAnalyzer);
+        applyConfig(configManager, *session.activityMonitor, *session.healthEngine, *session.dataAnalyzer);
+
+        // 无法在其他用户的桌面上弹出托盘通知，提醒只记录日志和健康事件
+        DataAnalyzer* dataAnalyzer = session.dataAnalyzer.get();
+        QObject::connect(session.healthEngine.get(), &HealthEngine::reminderTriggered, dataAnalyzer,
+                         [dataAnalyzer, display](HealthEngine::ReminderType type, const QString& message, const QString&) {
+                             Logger::info(QString("[%1] %2").arg(display, message), "MultiDisplay");
+                             dataAnalyzer->recordHealthEvent(type, "reminder_triggered");
+                         });
+
+        session.activityMonitor->start();
+        session.healthEngine->start();
+        sessions.push_back(std::move(session));
+    }
+
+    QObject::connect(&app, &QApplication::aboutToQuit, [&sessions]() {
+        for (DisplaySession& session : sessions) {
+            session.activityMonitor->stop();
+            session.healthEngine->stop();
+        }
+    });
+
+    Logger::info(QString("多显示器模式已启动，共 %1 个显示").arg(displays.size()));
+    return app.exec();
+}
+
+// 轨迹回放模式：不需要系统托盘和显示服务，回放结束后保存数据并退出
+static int runTraceReplay(QApplication& app, const QString& tracePath,
+                          const QString& speedText, const QString& outputPath)
+{
+    double speed = TraceReplayer::MaxSpeed;
+    if (speedText != "max") {
+        bool ok = false;
+        speed = speedText.toDouble(&ok);
+        if (!ok || speed <= 0.0) {
+            std::cerr << "Invalid --replay-speed, expected a positive number or \"max\"" << std::endl;
+            return -1;
+        }
+    }
+
+    // 回放结果写入独立文件，每次从空数据开始，保证多次回放输出一致
+    QString dataPath = outputPath.isEmpty() ? tracePath + ".replay.json" : outputPath;
+    QFile::remove(dataPath);
+    ActivityJournal::remove(ActivityJournal::pathForDataFile(dataPath));
+
+    ActivityMonitor activityMonitor;
+    HealthEngine healthEngine;
+    DataAnalyzer dataAnalyzer(dataPath);
+    connectActivityPipeline(activityMonitor, healthEngine, dataAnalyzer);
+
+    TraceReplayer replayer(&activityMonitor);
+    if (!replayer.open(tracePath)) {
+        return -1;
+    }
+    replayer.setSpeed(speed);
+    // 回放结束时补发未满一分钟的聚合桶，再退出
+    QObject::connect(&replayer, &TraceReplayer::finished, &app, [&app, &activityMonitor]() {
+        activityMonitor.flushAggregation();
+        app.quit();
+    }, Qt::QueuedConnection);
+    replayer.start();
+
+    int result = app.exec();
+    Logger::info(QString("回放结果已写入: %1").arg(ActivityJournal::pathForDataFile(dataPath)));
+    return result;
+}
+
 int main(int argc, char *argv[])
 {
     std::cerr << "DEBUG: Point 1 - main() entry" << std::endl;
@@ -27,6 +224,42 @@ int main(int argc, char *argv[])
     app.setOrganizationDomain("workstationwellness.com");
     std::cerr << "DEBUG: Point 3 - Application info set" << std::endl;
 
+#ifdef Q_OS_LINUX
+    // Xlib 错误处理函数是进程级的，在打开任何 X 连接之前安装
+    WindowTracker::installErrorHandler();
+#endif
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption recordTraceOption("record-trace", "Record activity samples to a trace file.", "file");
+    QCommandLineOption replayTraceOption("replay-trace", "Replay a recorded trace through the pipeline and exit.", "file");
+    QCommandLineOption replaySpeedOption("replay-speed", "Replay speed: 1 (real time), N (N times faster) or max.", "speed", "1");
+    QCommandLineOption replayOutputOption("replay-output", "Data file written by a replay; records go to the .journal file of the same name (default: <trace>.replay.json).", "file");
+    QCommandLineOption displaysOption("displays", "Monitor several X displays in one headless process (comma separated, e.g. :10,:11).", "list");
+    parser.addOption(recordTraceOption);
+    parser.addOption(replayTraceOption);
+    parser.addOption(replaySpeedOption);
+    parser.addOption(replayOutputOption);
+    parser.addOption(displaysOption);
+    parser.process(app);
+
+    if (parser.isSet(replayTraceOption)) {
+        Logger::initialize();
+        return runTraceReplay(app, parser.value(replayTraceOption),
+                              parser.value(replaySpeedOption), parser.value(replayOutputOption));
+    }
+
+    if (parser.isSet(displaysOption)) {
+        const QStringList displays = parser.value(displaysOption).split(',', Qt::SkipEmptyParts);
+        if (displays.isEmpty()) {
+            std::cerr << "--displays requires at least one display" << std::endl;
+            return -1;
+        }
+        Logger::initialize();
+        return runMultiDisplay(app, displays);
+    }
+
     // 检查系统托盘是否可用
     std::cerr << "DEBUG: Point 4 - Checking system tray availability" << std::endl;
     if (!QSystemTrayIcon::isSystemTrayAvailable()) {
@@ -52,6 +285,9 @@ int main(int argc, char *argv[])
         Logger::warning("配置文件加载失败，使用默认配置");
     }
 
+    // 轨迹录制器须比活动监测模块存活更久
+    TraceRecorder traceRecorder;
+
     // 初始化核心模块
     ActivityMonitor activityMonitor;
     HealthEngine healthEngine;
@@ -61,13 +297,11 @@ int main(int argc, char *argv[])
     SystemTrayIcon trayIcon(&dataAnalyzer);
     trayIcon.show();
 
-    // 连接信号槽 - 活动监测 -> 健康引擎
-    QObject::connect(&activityMonitor, &ActivityMonitor::activityDetected,
-                     &healthEngine, &HealthEngine::onActivityDetected);
+    connectActivityPipeline(activityMonitor, healthEngine, dataAnalyzer);
 
-    // 连接信号槽 - 活动监测 -> 数据分析
-    QObject::connect(&activityMonitor, &ActivityMonitor::activityDetected,
-                     &dataAnalyzer, &DataAnalyzer::recordActivity);
+    if (parser.isSet(recordTraceOption) && traceRecorder.open(parser.value(recordTraceOption))) {
+        activityMonitor.setTraceRecorder(&traceRecorder);
+    }
 
     // 连接信号槽 - 健康引擎 -> 系统托盘
     QObject::connect(&healthEngine, &HealthEngine::reminderTriggered,
@@ -86,35 +320,13 @@ int main(int argc, char *argv[])
     // 连接信号槽 - 配置变更
     QObject::connect(&configManager, &ConfigManager::configChanged, [&]() {
         // 更新健康引擎配置
-        auto reminderTypes = {
-            HealthEngine::ReminderType::SittingTooLong,
-            HealthEngine::ReminderType::EyeRest,
-            HealthEngine::ReminderType::NeckExercise,
-            HealthEngine::ReminderType::PostureCheck,
-            HealthEngine::ReminderType::Hydration
-        };
-
-        for (auto type : reminderTypes) {
-            auto config = configManager.getReminderConfig(type);
-            healthEngine.configureReminder(type, config);
-        }
+        applyConfig(configManager, activityMonitor, healthEngine, dataAnalyzer);
 
         Logger::info("健康引擎配置已更新");
     });
 
     // 应用初始配置
-    auto reminderTypes = {
-        HealthEngine::ReminderType::SittingTooLong,
-        HealthEngine::ReminderType::EyeRest,
-        HealthEngine::ReminderType::NeckExercise,
-        HealthEngine::ReminderType::PostureCheck,
-        HealthEngine::ReminderType::Hydration
-    };
-
-    for (auto type : reminderTypes) {
-        auto config = configManager.getReminderConfig(type);
-        healthEngine.configureReminder(type, config);
-    }
+    applyConfig(configManager, activityMonitor, healthEngine, dataAnalyzer);
 
     // 启动核心模块
     activityMonitor.start();
@@ -140,6 +352,8 @@ int main(int argc, char *argv[])
         Logger::info("工位健康精灵正在退出...");
 
         activityMonitor.stop();
+        activityMonitor.setTraceRecorder(nullptr);
+        traceRecorder.close();
         healthEngine.stop();
 
         // 保存配置和数据
@@ -274,7 +274,7 @@ void SettingsDialog::createAdvancedTab()
     dataLayout->addRow(m_collectStatsCheck);
     dataLayout->addRow(m_enableLoggingCheck);
     dataLayout->addRow("日志级别:", m_logLevelCombo);
-    dataLayout->addRow("数据保留:", m_dataRetentionSpin);
+    dataLayout->addRow("分钟数据保留:", m_dataRetentionSpin);
     dataLayout->addRow(m_smartAdaptationCheck);
     
     // 配置管理组
@@ -43,12 +43,14 @@ void StatisticsPanel::setupUi()
     m_totalBreaksLabel = new QLabel(this);
     m_longestSessionLabel = new QLabel(this);
     m_healthScoreLabel = new QLabel(this);
+    m_typingCadenceLabel = new QLabel(this);
 
     formLayout->addRow(tr("日期:"), m_reportDateLabel);
     formLayout->addRow(tr("总计专注时间:"), m_totalActiveLabel);
     formLayout->addRow(tr("总计休息次数:"), m_totalBreaksLabel);
     formLayout->addRow(tr("最长连续专注:"), m_longestSessionLabel);
     formLayout->addRow(tr("健康得分:"), m_healthScoreLabel);
+    formLayout->addRow(tr("按键间隔 (P50/P95):"), m_typingCadenceLabel);
 
     m_refreshButton = new QPushButton(tr("刷新数据"), this);
 
@@ -79,6 +81,14 @@ void StatisticsPanel::updateLabels(const DataAnalyzer::DailyReport& report)
     m_totalBreaksLabel->setText(tr("%1 次").arg(report.totalBreaks));
     m_longestSessionLabel->setText(tr("%1 分钟").arg(report.longestSittingSession));
     
+    if (report.keyIntervalP50Ms > 0) {
+        m_typingCadenceLabel->setText(tr("%1 / %2 毫秒")
+                                      .arg(qRound(report.keyIntervalP50Ms))
+                                      .arg(qRound(report.keyIntervalP95Ms)));
+    } else {
+        m_typingCadenceLabel->setText(tr("无数据"));
+    }
+
     m_healthScoreLabel->setText(QString::number(report.healthScore, 'f', 1));
     if (report.healthScore >= 85) {
         m_healthScoreLabel->setStyleSheet("color: green;");
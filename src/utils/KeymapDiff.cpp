@@ -0,0 +1,77 @@
+#include "utils/KeymapDiff.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KEYMAPDIFF_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline int popcount64(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(value));
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 256 位结果按 4 个 64 位字统计
+inline int popcount256(const std::uint64_t words[4])
+{
+    return popcount64(words[0]) + popcount64(words[1]) + popcount64(words[2]) + popcount64(words[3]);
+}
+
+} // namespace
+
+int KeymapDiff::countNewlyPressed(const unsigned char* previous, const unsigned char* current)
+{
+    std::uint64_t pressed[4];
+
+#if defined(__AVX2__)
+    // andnot(a, b) = ~a & b，一条指令完成整张位图
+    const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous));
+    const __m256i curr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pressed), _mm256_andnot_si256(prev, curr));
+#elif defined(KEYMAPDIFF_SSE2)
+    const __m128i prevLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous));
+    const __m128i prevHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + 16));
+    const __m128i currLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+    const __m128i currHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pressed), _mm_andnot_si128(prevLow, currLow));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pressed + 2), _mm_andnot_si128(prevHigh, currHigh));
+#else
+    std::uint64_t prev[4];
+    std::memcpy(prev, previous, Bytes);
+    std::memcpy(pressed, current, Bytes);
+    for (int i = 0; i < 4; ++i) {
+        pressed[i] &= ~prev[i];
+    }
+#endif
+
+    return popcount256(pressed);
+}
+
+const char* KeymapDiff::implementation()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(KEYMAPDIFF_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,73 @@
+#include "utils/LogHistogram.h"
+#include <cmath>
+
+int LogHistogram::bucketFor(qint64 intervalMs)
+{
+    if (intervalMs < MinIntervalMs) {
+        return 0;
+    }
+
+    // 整数运算求 floor(4 * log2(v / 8))：先取整数倍频程，再用 v^4 与 2^(4k+j) 比较得到四分之一倍频程
+    const quint64 v = static_cast<quint64>(intervalMs);
+    int octave = 0;
+    while ((v >> (octave + 1)) != 0) {
+        ++octave;
+    }
+    const quint64 v4 = v * v * v * v;
+    int quarter = 0;
+    while (quarter < 3 && v4 >= (quint64(1) << (4 * octave + quarter + 1))) {
+        ++quarter;
+    }
+
+    const int bucket = 4 * (octave - 3) + quarter;
+    return bucket < BucketCount ? bucket : BucketCount - 1;
+}
+
+double LogHistogram::bucketLowerBound(int bucket)
+{
+    return MinIntervalMs * std::exp2(bucket / 4.0);
+}
+
+void LogHistogram::merge(const LogHistogram& other)
+{
+    for (int i = 0; i < BucketCount; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+}
+
+LogHistogram LogHistogram::since(const LogHistogram& earlier) const
+{
+    LogHistogram delta;
+    for (int i = 0; i < BucketCount; ++i) {
+        delta.m_counts[i] = m_counts[i] - earlier.m_counts[i];
+    }
+    return delta;
+}
+
+quint64 LogHistogram::total() const
+{
+    quint64 sum = 0;
+    for (quint32 count : m_counts) {
+        sum += count;
+    }
+    return sum;
+}
+
+double LogHistogram::percentile(double p) const
+{
+    const quint64 sum = total();
+    if (sum == 0) {
+        return 0.0;
+    }
+
+    // 第 rank 个样本（从 1 开始）所在的桶
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(std::ceil(sum * qBound(0.0, p, 100.0) / 100.0)));
+    quint64 cumulative = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        cumulative += m_counts[i];
+        if (cumulative >= rank) {
+            return MinIntervalMs * std::exp2((i + 0.5) / 4.0);
+        }
+    }
+    return bucketLowerBound(BucketCount - 1);
+}
@@ -0,0 +1,94 @@
+#include "utils/MonotonicClock.h"
+#include <QDateTime>
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <time.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <realtimeapiset.h>
+#else
+#include <QElapsedTimer>
+#endif
+
+namespace {
+
+constexpr qint64 kResyncIntervalNs = 60LL * 1000 * 1000 * 1000;
+
+// 墙上时间 = 包含挂起时间的时钟 + 偏移；挂起前后偏移不变，只需定期校正时钟调整
+std::atomic<qint64> s_wallOffsetNs{0};
+std::atomic<qint64> s_lastSyncNs{0};
+std::atomic<bool> s_synchronized{false};
+
+#ifdef Q_OS_LINUX
+qint64 readClock(clockid_t clock)
+{
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+// 包含挂起时间的单调时钟
+qint64 bootNanoseconds()
+{
+#ifdef Q_OS_LINUX
+    return readClock(CLOCK_BOOTTIME);
+#elif defined(Q_OS_WIN)
+    ULONGLONG interruptTime = 0;
+    QueryInterruptTime(&interruptTime); // 100ns 单位，包含睡眠
+    return static_cast<qint64>(interruptTime) * 100;
+#else
+    return MonotonicClock::nanoseconds();
+#endif
+}
+
+} // namespace
+
+qint64 MonotonicClock::nanoseconds()
+{
+#ifdef Q_OS_LINUX
+    return readClock(CLOCK_MONOTONIC_COARSE);
+#elif defined(Q_OS_WIN)
+    ULONGLONG unbiased = 0;
+    QueryUnbiasedInterruptTime(&unbiased); // 100ns 单位，不含睡眠
+    return static_cast<qint64>(unbiased) * 100;
+#else
+    static QElapsedTimer timer = [] { QElapsedTimer t; t.start(); return t; }();
+    return timer.nsecsElapsed();
+#endif
+}
+
+qint64 MonotonicClock::currentUnixMs()
+{
+    const qint64 boot = bootNanoseconds();
+    if (!s_synchronized.load(std::memory_order_acquire) ||
+        boot - s_lastSyncNs.load(std::memory_order_relaxed) > kResyncIntervalNs) {
+        resynchronize();
+        return QDateTime::currentMSecsSinceEpoch();
+    }
+    return (boot + s_wallOffsetNs.load(std::memory_order_relaxed)) / 1000000;
+}
+
+qint64 MonotonicClock::suspendedNanoseconds()
+{
+#ifdef Q_OS_LINUX
+    return qMax<qint64>(0, readClock(CLOCK_BOOTTIME) - readClock(CLOCK_MONOTONIC));
+#elif defined(Q_OS_WIN)
+    ULONGLONG interruptTime = 0, unbiased = 0;
+    QueryInterruptTime(&interruptTime);
+    QueryUnbiasedInterruptTime(&unbiased);
+    return qMax<qint64>(0, static_cast<qint64>(interruptTime - unbiased) * 100);
+#else
+    return 0;
+#endif
+}
+
+void MonotonicClock::resynchronize()
+{
+    const qint64 boot = bootNanoseconds();
+    const qint64 wallNs = QDateTime::currentMSecsSinceEpoch() * 1000000;
+    s_wallOffsetNs.store(wallNs - boot, std::memory_order_relaxed);
+    s_lastSyncNs.store(boot, std::memory_order_relaxed);
+    s_synchronized.store(true, std::memory_order_release);
+}
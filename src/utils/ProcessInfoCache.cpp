@@ -0,0 +1,144 @@
+#include "utils/ProcessInfoCache.h"
+#include "utils/StringInternPool.h"
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr int kPruneThreshold = 256; // 缓存超过该数量时清理已退出的进程
+
+#ifdef Q_OS_LINUX
+// /proc/<pid>/stat 第 22 项：开机以来的启动时间（时钟节拍），进程不存在时返回 0
+quint64 processStartTime(qint64 pid)
+{
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray stat = file.read(1024);
+
+    // 第 2 项 comm 可能包含空格和括号，从最后一个 ')' 之后开始计数（第 3 项起）
+    const int commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0) {
+        return 0;
+    }
+    const QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    constexpr int kStartTimeIndex = 22 - 3;
+    return fields.size() > kStartTimeIndex ? fields.at(kStartTimeIndex).toULongLong() : 0;
+}
+
+QString readApplicationName(qint64 pid)
+{
+    // 优先使用可执行文件名；其他用户的进程无权读取 exe 链接时退回到 comm（最多 15 个字符）
+    const QString exe = QFile::symLinkTarget(QString("/proc/%1/exe").arg(pid));
+    if (!exe.isEmpty()) {
+        return QFileInfo(exe).fileName();
+    }
+
+    QFile comm(QString("/proc/%1/comm").arg(pid));
+    if (comm.open(QIODevice::ReadOnly)) {
+        return QString::fromUtf8(comm.readAll()).trimmed();
+    }
+    return QString();
+}
+#elif defined(Q_OS_WIN)
+quint64 processStartTime(qint64 pid, QString* name = nullptr)
+{
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        return 0;
+    }
+
+    quint64 startTime = 0;
+    FILETIME creation, exitTime, kernel, user;
+    DWORD exitCode = 0;
+    if (GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE &&
+        GetProcessTimes(process, &creation, &exitTime, &kernel, &user)) {
+        startTime = (static_cast<quint64>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+    }
+
+    if (name && startTime) {
+        WCHAR path[MAX_PATH];
+        DWORD length = MAX_PATH;
+        if (QueryFullProcessImageNameW(process, 0, path, &length)) {
+            *name = QFileInfo(QString::fromWCharArray(path, static_cast<int>(length))).fileName();
+        }
+    }
+    CloseHandle(process);
+    return startTime;
+}
+
+QString readApplicationName(qint64 pid)
+{
+    QString name;
+    processStartTime(pid, &name);
+    return name;
+}
+#else
+quint64 processStartTime(qint64 pid)
+{
+    Q_UNUSED(pid);
+    return 0;
+}
+
+QString readApplicationName(qint64 pid)
+{
+    Q_UNUSED(pid);
+    return QString();
+}
+#endif
+
+} // namespace
+
+ProcessInfoCache& ProcessInfoCache::instance()
+{
+    static ProcessInfoCache cache;
+    return cache;
+}
+
+quint32 ProcessInfoCache::applicationId(qint64 pid)
+{
+    if (pid <= 0) {
+        return StringInternPool::EmptyId;
+    }
+
+    // 只在活跃窗口的进程变化时调用，启动时间校验只需读取一个很小的文件
+    const quint64 startTime = processStartTime(pid);
+    if (startTime == 0) {
+        return StringInternPool::EmptyId;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(pid);
+    if (it != m_entries.constEnd() && it->startTime == startTime) {
+        return it->applicationId;
+    }
+
+    const quint32 id = StringInternPool::applications().intern(readApplicationName(pid));
+    if (m_entries.size() >= kPruneThreshold) {
+        pruneExited();
+    }
+    m_entries.insert(pid, {startTime, id});
+    return id;
+}
+
+int ProcessInfoCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_entries.size());
+}
+
+void ProcessInfoCache::pruneExited()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (processStartTime(it.key()) != it->startTime) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include "utils/StorageWriter.h"
+#include "utils/Logger.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+namespace {
+
+// 把已写入的数据刷到磁盘；追加只在组提交时发生，每次提交每个文件同步一次
+bool syncToDisk(QFile& file)
+{
+#ifdef Q_OS_LINUX
+    return ::fdatasync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#else
+    Q_UNUSED(file);
+    return true;
+#endif
+}
+
+} // namespace
+
+StorageWriter::StorageWriter(int maxThreads)
+{
+    m_pool.setMaxThreadCount(qMax(1, maxThreads));
+}
+
+StorageWriter::~StorageWriter()
+{
+    waitForDone();
+}
+
+QFuture<bool> StorageWriter::write(const QString& filePath, const QByteArray& data)
+{
+    return submit(filePath, data, false);
+}
+
+QFuture<bool> StorageWriter::append(const QString& filePath, const QByteArray& data)
+{
+    return submit(filePath, data, true);
+}
+
+QFuture<bool> StorageWriter::submit(const QString& filePath, const QByteArray& data, bool append)
+{
+    auto result = std::make_shared<QPromise<bool>>();
+    result->start();
+    const QFuture<bool> future = result->future();
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_pending.find(filePath);
+        if (it == m_pending.end()) {
+            m_pending.insert(filePath, {data, append, {result}});
+        } else if (append) {
+            // 接在尚未落盘的内容之后；若之前是整体替换，追加的内容成为新文件的一部分
+            it->data.append(data);
+            it->results.append(result);
+        } else {
+            // 被替换的写入不再落盘，其结果随替换它的写入给出
+            it->data = data;
+            it->append = false;
+            it->results.append(result);
+        }
+        if (m_inFlight.contains(filePath)) {
+            return future; // 正在写入该路径的任务结束前会取走最新内容
+        }
+        m_inFlight.insert(filePath);
+    }
+    m_pool.start([this, filePath]() { drain(filePath); });
+    return future;
+}
+
+void StorageWriter::waitForDone()
+{
+    m_pool.waitForDone();
+}
+
+void StorageWriter::drain(const QString& filePath)
+{
+    for (;;) {
+        PendingWrite pending;
+        {
+            QMutexLocker locker(&m_mutex);
+            auto it = m_pending.find(filePath);
+            if (it == m_pending.end()) {
+                m_inFlight.remove(filePath);
+                return;
+            }
+            pending = std::move(it.value());
+            m_pending.erase(it);
+        }
+        const bool ok = pending.append ? appendFile(filePath, pending.data) : writeFile(filePath, pending.data);
+        for (const auto& result : pending.results) {
+            result->addResult(ok);
+            result->finish();
+        }
+    }
+}
+
+bool StorageWriter::writeFile(const QString& filePath, const QByteArray& data)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        Logger::warning(QString("无法打开文件写入: %1").arg(filePath), "StorageWriter");
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        Logger::warning(QString("写入文件失败: %1").arg(filePath), "StorageWriter");
+        return false;
+    }
+    if (!file.commit()) {
+        Logger::warning(QString("写入文件失败: %1").arg(filePath), "StorageWriter");
+        return false;
+    }
+    return true;
+}
+
+bool StorageWriter::appendFile(const QString& filePath, const QByteArray& data)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        Logger::warning(QString("无法打开文件追加: %1").arg(filePath), "StorageWriter");
+        return false;
+    }
+    if (file.write(data) != data.size() || !file.flush() || !syncToDisk(file)) {
+        Logger::warning(QString("追加文件失败: %1").arg(filePath), "StorageWriter");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,143 @@
+#include "utils/StringInternPool.h"
+#include "utils/Logger.h"
+
+StringInternPool::StringInternPool(int capacity, Normalizer normalizer)
+    : m_capacity(capacity)
+    , m_normalizer(normalizer)
+    , m_nextId(EmptyId + 1)
+    , m_generation(0)
+{
+    m_strings.insert(EmptyId, QString());
+}
+
+StringInternPool& StringInternPool::titles()
+{
+    static StringInternPool pool(MaxTitles, &StringInternPool::normalizeTitle);
+    return pool;
+}
+
+StringInternPool& StringInternPool::applications()
+{
+    static StringInternPool pool(MaxApplications, nullptr);
+    return pool;
+}
+
+QString StringInternPool::normalizeTitle(const QString& title)
+{
+    QString result;
+    result.reserve(title.size());
+    bool inDigits = false;
+    for (const QChar ch : title) {
+        const bool digit = ch.isDigit();
+        if (digit) {
+            if (!inDigits) {
+                result.append(QLatin1Char('#'));
+            }
+        } else if (ch.isSpace()) {
+            if (!result.isEmpty() && !result.endsWith(QLatin1Char(' '))) {
+                result.append(QLatin1Char(' '));
+            }
+        } else {
+            result.append(ch);
+        }
+        inDigits = digit;
+    }
+    return result.trimmed();
+}
+
+quint32 StringInternPool::intern(const QString& rawValue)
+{
+    const QString value = m_normalizer && rawValue.size() > MaxTitleLength ? rawValue.left(MaxTitleLength) : rawValue;
+    if (value.isEmpty()) {
+        return EmptyId;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_entries.constFind(value);
+        if (it != m_entries.constEnd() && it->generation == m_generation) {
+            return it->id;
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    // 获取写锁期间可能已被其他线程插入；命中的条目记为本代用过
+    auto it = m_entries.find(value);
+    if (it != m_entries.end()) {
+        it->generation = m_generation;
+        return it->id;
+    }
+
+    // 同族已保存足够多的原文：沿用最近保存的那个，不再为每个变体分配 ID
+    QString familyKey;
+    if (m_normalizer) {
+        familyKey = m_normalizer(value);
+        auto family = m_families.constFind(familyKey);
+        if (family != m_families.constEnd() && family->variants >= MaxTitleVariants) {
+            auto latest = m_entries.find(m_strings.value(family->latestId));
+            if (latest != m_entries.end()) {
+                latest->generation = m_generation;
+            }
+            return family->latestId;
+        }
+    }
+
+    if (m_entries.size() + 1 >= m_capacity) {
+        evictLocked();
+    }
+
+    const quint32 id = m_nextId++;
+    m_generation = (id - 1) / qMax(1, m_capacity / 4);
+    m_entries.insert(value, {id, m_generation, familyKey});
+    m_strings.insert(id, value);
+    if (m_normalizer) {
+        Family& family = m_families[familyKey];
+        family.variants++;
+        family.latestId = id;
+    }
+    return id;
+}
+
+void StringInternPool::evictLocked()
+{
+    auto evictOlderThan = [this](quint32 generation) {
+        int removed = 0;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->generation >= generation) {
+                ++it;
+                continue;
+            }
+            m_strings.remove(it->id);
+            auto family = m_families.find(it->familyKey);
+            if (family != m_families.end() && family->latestId == it->id) {
+                m_families.erase(family);
+            }
+            it = m_entries.erase(it);
+            removed++;
+        }
+        return removed;
+    };
+
+    // 回收本代和上一代都没有驻留过的字符串；最近用过的字符串占满整个池时只保留本代的，再不行整池清空
+    int removed = evictOlderThan(m_generation > 0 ? m_generation - 1 : 0);
+    if (removed == 0) {
+        removed = evictOlderThan(m_generation);
+    }
+    if (removed == 0) {
+        removed = evictOlderThan(m_generation + 1);
+    }
+    Logger::info(QString("字符串驻留池已满（%1 项），回收了 %2 个最近未用的字符串").arg(m_capacity).arg(removed),
+                 "StringInternPool");
+}
+
+QString StringInternPool::resolve(quint32 id) const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.value(id);
+}
+
+int StringInternPool::size() const
+{
+    QReadLocker locker(&m_lock);
+    return static_cast<int>(m_strings.size());
+}
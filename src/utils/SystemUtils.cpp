@@ -1,5 +1,7 @@
 #include "utils/SystemUtils.h"
 #include "utils/Logger.h"
+#include "utils/ProcessInfoCache.h"
+#include "utils/StringInternPool.h"
 #include <QSettings>
 #include <QApplication>
 #include <QScreen>
@@ -9,6 +11,7 @@
 #include <QProcess>
 #include <QNetworkInterface>
 #include <QSysInfo>
+#include <atomic>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -49,52 +52,36 @@ QString SystemUtils::getActiveWindowTitle()
 #endif
 }
 
+namespace {
+
+// 由默认显示的活动采集线程发布，读取时不产生任何窗口系统请求
+std::atomic<quint32> s_activeApplicationId{StringInternPool::EmptyId};
+std::atomic<bool> s_fullscreenApplication{false};
+
+} // namespace
+
 QString SystemUtils::getActiveApplicationName()
 {
+    const quint32 applicationId = s_activeApplicationId.load(std::memory_order_relaxed);
+    if (applicationId != StringInternPool::EmptyId) {
+        return StringInternPool::applications().resolve(applicationId);
+    }
+
 #ifdef Q_OS_WIN
+    // 采集未运行时直接查询前台窗口所属进程
     HWND hwnd = GetForegroundWindow();
     if (hwnd) {
-        DWORD processId;
+        DWORD processId = 0;
         GetWindowThreadProcessId(hwnd, &processId);
-        
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-        if (hProcess) {
-            WCHAR processName[MAX_PATH];
-            if (GetModuleBaseNameW(hProcess, NULL, processName, MAX_PATH)) {
-                CloseHandle(hProcess);
-                return QString::fromWCharArray(processName);
-            }
-            CloseHandle(hProcess);
-        }
-    }
-    return QString();
-#elif defined(Q_OS_LINUX)
-    // Linux 实现
-    Display* display = XOpenDisplay(nullptr);
-    if (!display) return QString();
-    
-    Window focused;
-    int revert;
-    XGetInputFocus(display, &focused, &revert);
-    
-    if (focused == PointerRoot || focused == None) {
-        XCloseDisplay(display);
-        return QString();
+        return StringInternPool::applications().resolve(ProcessInfoCache::instance().applicationId(processId));
     }
-    
-    char* windowName = nullptr;
-    if (XFetchName(display, focused, &windowName) && windowName) {
-        QString result = QString::fromLocal8Bit(windowName);
-        XFree(windowName);
-        XCloseDisplay(display);
-        return result;
-    }
-    
-    XCloseDisplay(display);
-    return QString();
-#else
-    return "Unknown Application";
 #endif
+    return QString();
+}
+
+void SystemUtils::setActiveApplicationId(quint32 applicationId)
+{
+    s_activeApplicationId.store(applicationId, std::memory_order_relaxed);
 }
 
 int SystemUtils::getSystemIdleTime()
@@ -148,16 +135,12 @@ QPoint SystemUtils::getMousePosition()
 
 bool SystemUtils::isFullscreenApplication()
 {
-    QRect screenGeometry = getScreenGeometry();
-    // 简单检测：如果窗口标题包含全屏相关关键词
-    QString activeWindow = getActiveWindowTitle().toLower();
-    
-    return activeWindow.contains("fullscreen") || 
-           activeWindow.contains("full screen") ||
-           activeWindow.contains("游戏") ||
-           activeWindow.contains("视频") ||
-           activeWindow.contains("movie") ||
-           activeWindow.contains("video");
+    return s_fullscreenApplication.load(std::memory_order_relaxed);
+}
+
+void SystemUtils::setFullscreenApplication(bool fullscreen)
+{
+    s_fullscreenApplication.store(fullscreen, std::memory_order_relaxed);
 }
 
 bool SystemUtils::setAutoStart(bool enabled, const QString& appName, const QString& appPath)
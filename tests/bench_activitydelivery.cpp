@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+#include "core/ActivityCapture.h"
+#include "core/ActivityMonitor.h"
+#include "utils/SpscRingBuffer.h"
+#include "utils/StringInternPool.h"
+
+/**
+ * @brief 采样从采集线程到消费者的各段开销
+ *
+ * - 采集线程与 GUI 线程之间的 SPSC 环形缓冲区
+ * - 采集端驻留窗口标题（命中已有 ID）与显示时解析
+ * - 逐秒 activityDetected 与按批 activityBatchReady 送到两个消费者（健康引擎、数据分析）的单采样开销，
+ *   按批投递的目标是每个采样 50 ns 以下，只在非调试构建中检查
+ */
+class BenchActivityDelivery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void ringAcrossThreads();
+    void ringPushPop();
+    void internExistingTitle();
+    void resolveTitle();
+    void deliveryPerSample();
+
+private:
+    static constexpr int kSamples = 1 << 20;          // 经过环形缓冲区的采样数
+    static constexpr int kDeliveredSamples = 1 << 16; // 送达消费者的采样数（消费者全部保存）
+    static constexpr double kBatchTargetNs = 50.0;    // 按批投递每个采样的开销上限
+    QStringList m_titles;
+    QList<quint32> m_titleIds;
+};
+
+void BenchActivityDelivery::initTestCase()
+{
+    for (int i = 0; i < 64; ++i) {
+        m_titles << QString("Window %1 - Application").arg(QChar('A' + i % 26)).repeated(1 + i % 3);
+    }
+    for (const QString& title : m_titles) {
+        m_titleIds << StringInternPool::titles().intern(title);
+    }
+}
+
+void BenchActivityDelivery::ringAcrossThreads()
+{
+    // 生产者与消费者各占一个线程，检查顺序与数量，并给出单个采样的吞吐开销
+    auto ring = std::make_unique<ActivityCapture::SampleRing>();
+    QElapsedTimer timer;
+    timer.start();
+    std::unique_ptr<QThread> producer(QThread::create([&ring]() {
+        ActivityCapture::Sample sample;
+        for (int i = 0; i < kSamples; ++i) {
+            sample.timestampMs = i;
+            while (!ring->tryPush(sample)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }));
+    producer->start();
+
+    ActivityCapture::Sample sample;
+    qint64 expected = 0;
+    bool ordered = true;
+    while (expected < kSamples) {
+        if (ring->tryPop(sample)) {
+            ordered = ordered && sample.timestampMs == expected;
+            expected++;
+        }
+    }
+    producer->wait();
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    QVERIFY(ordered);
+    QVERIFY(ring->isEmpty());
+    qInfo("跨线程环形缓冲区：每个采样 %.1f ns", double(elapsedNs) / kSamples);
+}
+
+void BenchActivityDelivery::ringPushPop()
+{
+    auto ring = std::make_unique<ActivityCapture::SampleRing>();
+    ActivityCapture::Sample sample;
+    ActivityCapture::Sample out;
+    QBENCHMARK {
+        for (int i = 0; i < 1024; ++i) {
+            sample.timestampMs = i;
+            ring->tryPush(sample);
+            ring->tryPop(out);
+        }
+    }
+    QCOMPARE(out.timestampMs, qint64(1023));
+}
+
+void BenchActivityDelivery::internExistingTitle()
+{
+    // 采集端只在标题变化时驻留；这里每次都命中已有 ID（读锁 + 哈希查找）
+    quint32 id = 0;
+    QBENCHMARK {
+        for (const QString& title : std::as_const(m_titles)) {
+            id = StringInternPool::titles().intern(title);
+        }
+    }
+    QCOMPARE(id, m_titleIds.last());
+}
+
+void BenchActivityDelivery::resolveTitle()
+{
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (quint32 id : std::as_const(m_titleIds)) {
+            length += StringInternPool::titles().resolve(id).size();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+void BenchActivityDelivery::deliveryPerSample()
+{
+    // 两个消费者都保存收到的数据：逐秒信号逐条复制，批量信号只增加引用计数
+    ActivityMonitor monitor;
+    QList<ActivityMonitor::ActivityData> perSampleSink[2];
+    QList<ActivityMonitor::ActivityBatch> batchSink[2];
+    for (int consumer = 0; consumer < 2; ++consumer) {
+        connect(&monitor, &ActivityMonitor::activityDetected, this,
+                [&perSampleSink, consumer](const ActivityMonitor::ActivityData& data) { perSampleSink[consumer].append(data); });
+        connect(&monitor, &ActivityMonitor::activityBatchReady, this,
+                [&batchSink, consumer](const ActivityMonitor::ActivityBatch& batch) { batchSink[consumer].append(batch); });
+    }
+
+    ActivityMonitor::ActivityData data;
+    data.timestamp = QDateTime::currentDateTime();
+    data.mouseClicks = 1;
+    data.keystrokes = 2;
+    data.isActive = true;
+    data.windowTitleId = m_titleIds.first();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kDeliveredSamples; ++i) {
+        emit monitor.activityDetected(data);
+    }
+    const double perSampleNs = double(timer.nsecsElapsed()) / kDeliveredSamples;
+
+    // 与 ActivityMonitor::appendToBatch 相同：满 64 条发出一次
+    constexpr int kBatchSize = 64;
+    timer.restart();
+    ActivityMonitor::ActivityBatch batch;
+    batch.reserve(kBatchSize);
+    for (int i = 0; i < kDeliveredSamples; ++i) {
+        batch.append(data);
+        if (batch.size() == kBatchSize) {
+            emit monitor.activityBatchReady(batch);
+            batch = ActivityMonitor::ActivityBatch();
+            batch.reserve(kBatchSize);
+        }
+    }
+    const double batchNs = double(timer.nsecsElapsed()) / kDeliveredSamples;
+
+    QCOMPARE(perSampleSink[1].size(), kDeliveredSamples);
+    QCOMPARE(batchSink[1].size(), kDeliveredSamples / kBatchSize);
+    qInfo("每个采样送达两个消费者：逐秒信号 %.1f ns，按批信号 %.1f ns（目标 < %.0f ns）",
+          perSampleNs, batchNs, kBatchTargetNs);
+    QVERIFY(batchNs < perSampleNs);
+#ifdef QT_DEBUG
+    QSKIP("调试构建不检查按批投递的开销目标");
+#else
+    QVERIFY2(batchNs < kBatchTargetNs, qPrintable(QString("按批投递每个采样 %1 ns，超过目标 %2 ns")
+                                                     .arg(batchNs, 0, 'f', 1).arg(kBatchTargetNs)));
+#endif
+}
+
+QTEST_GUILESS_MAIN(BenchActivityDelivery)
+#include "bench_activitydelivery.moc"
@@ -0,0 +1,187 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include "core/ActivityJournal.h"
+#include "core/DataAnalyzer.h"
+#include "utils/StringInternPool.h"
+
+/**
+ * @brief 90 天数据下活动日志的保存与查询开销
+ *
+ * 每天 8 小时工作：每分钟一个桶、每 10 分钟一个焦点区间、每 2 小时一次休息，
+ * 最近 7 天另有逐秒记录（约 3 万条/天）。保存只追加新记录，开销应与已有天数无关。
+ */
+class BenchJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void appendMinute_data();
+    void appendMinute();
+    void queryUncachedDay();
+    void weeklyTrend();
+    void openJournal();
+
+private:
+    static void fillDay(ActivityJournal* journal, const QDate& date, bool perSecond);
+    QString buildHistory(const QString& name, int days);
+
+    QTemporaryDir m_dir;
+    QDate m_today;
+    QString m_ninetyDays;
+};
+
+void BenchJournal::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+    m_today = QDate(2026, 6, 30);
+
+    QElapsedTimer timer;
+    timer.start();
+    m_ninetyDays = buildHistory("history90", 90);
+    qInfo("生成 90 天数据用时 %lld ms", timer.elapsed());
+}
+
+void BenchJournal::fillDay(ActivityJournal* journal, const QDate& date, bool perSecond)
+{
+    const quint32 titles[] = {
+        StringInternPool::titles().intern("report.docx - Writer"),
+        StringInternPool::titles().intern("Inbox - Mail"),
+        StringInternPool::titles().intern("dashboard - Browser"),
+    };
+    const qint64 dayStartMs = QDateTime(date, QTime(9, 0)).toMSecsSinceEpoch();
+    for (int minute = 0; minute < 8 * 60; ++minute) {
+        const qint64 minuteStartMs = dayStartMs + minute * 60 * 1000LL;
+        const quint32 titleId = titles[(minute / 10) % 3];
+        if (perSecond) {
+            for (int second = 0; second < 60; ++second) {
+                ActivityMonitor::ActivityData data;
+                data.timestamp = QDateTime::fromMSecsSinceEpoch(minuteStartMs + second * 1000);
+                data.mouseClicks = minute * 10 + second / 6;
+                data.keystrokes = minute * 120 + second * 2;
+                data.isActive = true;
+                data.windowTitleId = titleId;
+                data.pointerDistance = 30.0;
+                journal->append(data);
+            }
+        }
+        ActivityMonitor::ActivityBucket bucket;
+        bucket.minuteStartMs = minuteStartMs;
+        bucket.activeSeconds = 50;
+        bucket.mouseClicks = 10;
+        bucket.keystrokes = 120;
+        bucket.dominantWindowTitleId = titleId;
+        bucket.keyIntervals.addInterval(150);
+        journal->append(bucket);
+        if (minute % 10 == 9) {
+            ActivityMonitor::FocusInterval interval;
+            interval.startMs = minuteStartMs - 9 * 60 * 1000LL;
+            interval.endMs = minuteStartMs + 60 * 1000LL;
+            interval.windowTitleId = titleId;
+            interval.activeSeconds = 500;
+            journal->append(interval);
+        }
+        if (minute % 120 == 119) {
+            ActivityMonitor::BreakInterval interval;
+            interval.startMs = minuteStartMs;
+            interval.endMs = minuteStartMs + 10 * 60 * 1000LL;
+            interval.sittingMs = 110 * 60 * 1000LL;
+            journal->append(interval);
+        }
+    }
+}
+
+QString BenchJournal::buildHistory(const QString& name, int days)
+{
+    const QString dataPath = m_dir.filePath(name + ".json");
+    ActivityJournal journal(ActivityJournal::pathForDataFile(dataPath));
+    if (!journal.open()) {
+        return QString();
+    }
+    for (int day = days - 1; day >= 0; --day) {
+        fillDay(&journal, m_today.addDays(-day), day < 7);
+        journal.flush();
+    }
+    return dataPath;
+}
+
+void BenchJournal::appendMinute_data()
+{
+    QTest::addColumn<QString>("dataPath");
+    QTest::newRow("1 day") << buildHistory("history1", 1);
+    QTest::newRow("90 days") << m_ninetyDays;
+}
+
+void BenchJournal::appendMinute()
+{
+    QFETCH(QString, dataPath);
+    QVERIFY(!dataPath.isEmpty());
+    ActivityJournal journal(ActivityJournal::pathForDataFile(dataPath));
+    QVERIFY(journal.open());
+    const qint64 beforeBytes = journal.summary(m_today).bytes;
+
+    // 一次组提交：一分钟的逐秒记录加一个分钟桶，追加并 fdatasync
+    qint64 timestampMs = QDateTime(m_today, QTime(18, 0)).toMSecsSinceEpoch();
+    int iterations = 0;
+    QBENCHMARK {
+        for (int second = 0; second < 60; ++second) {
+            ActivityMonitor::ActivityData data;
+            data.timestamp = QDateTime::fromMSecsSinceEpoch(timestampMs);
+            data.isActive = true;
+            journal.append(data);
+            timestampMs += 1000;
+        }
+        ActivityMonitor::ActivityBucket bucket;
+        bucket.minuteStartMs = timestampMs - 60 * 1000;
+        bucket.activeSeconds = 60;
+        journal.append(bucket);
+        QVERIFY(journal.commit());
+        iterations++;
+    }
+    // 只追加新记录：段增长的字节数与新增记录数一致
+    QCOMPARE(journal.summary(m_today).bytes - beforeBytes, qint64(iterations) * 61 * JournalFormat::RecordSize);
+    journal.flush();
+}
+
+void BenchJournal::queryUncachedDay()
+{
+    // 轮流查询 30 个不同的日子，超过缓存的 8 天，每次都要读取当天的段
+    DataAnalyzer analyzer(m_ninetyDays);
+    int day = 0;
+    int activeMinutes = 0;
+    QBENCHMARK {
+        activeMinutes += analyzer.getDailyReport(m_today.addDays(-30 - day)).totalActiveMinutes;
+        day = (day + 1) % 30;
+    }
+    QVERIFY(activeMinutes > 0);
+}
+
+void BenchJournal::weeklyTrend()
+{
+    DataAnalyzer analyzer(m_ninetyDays);
+    int week = 0;
+    int activeHours = 0;
+    QBENCHMARK {
+        activeHours += analyzer.getWeeklyTrend(m_today.addDays(-7 * (1 + week))).totalActiveHours;
+        week = (week + 1) % 12;
+    }
+    QVERIFY(activeHours > 0);
+}
+
+void BenchJournal::openJournal()
+{
+    // 启动时只读取字典与清单，不扫描段
+    int days = 0;
+    QBENCHMARK {
+        ActivityJournal journal(ActivityJournal::pathForDataFile(m_ninetyDays));
+        QVERIFY(journal.open());
+        days = journal.days().size();
+    }
+    QCOMPARE(days, 90);
+}
+
+QTEST_GUILESS_MAIN(BenchJournal)
+#include "bench_journal.moc"
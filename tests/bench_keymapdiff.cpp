@@ -0,0 +1,87 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "utils/KeymapDiff.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief 按键位图边沿检测的单次轮询开销
+ *
+ * 每次基准迭代比较 kPolls 对预先生成的位图，单次轮询的开销为结果除以 kPolls。
+ * 运行：./bench_keymapdiff -tickcounter 或 -minimumvalue 10000
+ */
+class BenchKeymapDiff : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void matchesBitLoop();
+    void countNewlyPressed();
+
+private:
+    static constexpr int kPolls = 1024;
+    static int referenceCount(const unsigned char* previous, const unsigned char* current);
+
+    // 连续的轮询位图：每次在上一次的基础上随机按下或释放少数几个键
+    std::vector<unsigned char> m_keymaps;
+};
+
+void BenchKeymapDiff::initTestCase()
+{
+    qInfo("KeymapDiff 实现: %s", KeymapDiff::implementation());
+
+    QRandomGenerator random(9);
+    m_keymaps.assign(static_cast<size_t>(kPolls + 1) * KeymapDiff::Bytes, 0);
+    for (int poll = 1; poll <= kPolls; ++poll) {
+        unsigned char* keymap = m_keymaps.data() + poll * KeymapDiff::Bytes;
+        std::copy_n(keymap - KeymapDiff::Bytes, KeymapDiff::Bytes, keymap);
+        const int changes = random.bounded(4);
+        for (int i = 0; i < changes; ++i) {
+            const int key = random.bounded(256);
+            keymap[key / 8] ^= static_cast<unsigned char>(1u << (key % 8));
+        }
+    }
+}
+
+int BenchKeymapDiff::referenceCount(const unsigned char* previous, const unsigned char* current)
+{
+    int count = 0;
+    for (int bit = 0; bit < KeymapDiff::Bytes * 8; ++bit) {
+        const bool wasDown = previous[bit / 8] & (1u << (bit % 8));
+        const bool isDown = current[bit / 8] & (1u << (bit % 8));
+        count += isDown && !wasDown ? 1 : 0;
+    }
+    return count;
+}
+
+void BenchKeymapDiff::matchesBitLoop()
+{
+    for (int poll = 1; poll <= kPolls; ++poll) {
+        const unsigned char* previous = m_keymaps.data() + (poll - 1) * KeymapDiff::Bytes;
+        const unsigned char* current = previous + KeymapDiff::Bytes;
+        QCOMPARE(KeymapDiff::countNewlyPressed(previous, current), referenceCount(previous, current));
+    }
+
+    // 全部按下、全部释放与未对齐的地址
+    alignas(32) unsigned char buffer[KeymapDiff::Bytes * 2 + 1] = {};
+    std::fill_n(buffer + 1 + KeymapDiff::Bytes, KeymapDiff::Bytes, 0xff);
+    QCOMPARE(KeymapDiff::countNewlyPressed(buffer + 1, buffer + 1 + KeymapDiff::Bytes), 256);
+    QCOMPARE(KeymapDiff::countNewlyPressed(buffer + 1 + KeymapDiff::Bytes, buffer + 1), 0);
+}
+
+void BenchKeymapDiff::countNewlyPressed()
+{
+    const unsigned char* keymaps = m_keymaps.data();
+    int pressed = 0;
+    QBENCHMARK {
+        for (int poll = 1; poll <= kPolls; ++poll) {
+            pressed += KeymapDiff::countNewlyPressed(keymaps + (poll - 1) * KeymapDiff::Bytes,
+                                                     keymaps + poll * KeymapDiff::Bytes);
+        }
+    }
+    QVERIFY(pressed > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchKeymapDiff)
+#include "bench_keymapdiff.moc"
@@ -0,0 +1,100 @@
+#include <QtTest>
+#include "core/ActivityColumns.h"
+
+/**
+ * @brief 列式存储的计数增量、整天求和与每条记录的内存占用
+ */
+class TestActivityColumns : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void firstSampleIsBaseline();
+    void counterResetRestartsDelta();
+    void fullDayTotals();
+
+private:
+    static ActivityMonitor::ActivityData sample(qint64 secs, int clicks, int keystrokes, bool active = true);
+};
+
+ActivityMonitor::ActivityData TestActivityColumns::sample(qint64 secs, int clicks, int keystrokes, bool active)
+{
+    ActivityMonitor::ActivityData data;
+    data.timestamp = QDateTime::fromSecsSinceEpoch(secs);
+    data.mouseClicks = clicks;
+    data.keystrokes = keystrokes;
+    data.isActive = active;
+    data.windowTitleId = 1;
+    data.applicationId = 1;
+    return data;
+}
+
+void TestActivityColumns::firstSampleIsBaseline()
+{
+    // 计数从采集开始累计，不在午夜或加载时归零：一天（或清空后）的第一条记录只作为基准，
+    // 否则之前各天的累计值会全部记到这一秒上
+    const qint64 base = QDateTime(QDate(2026, 3, 2), QTime(9, 0)).toSecsSinceEpoch();
+    ActivityColumns columns;
+    columns.append(sample(base, 50000, 120000));
+    columns.append(sample(base + 1, 50003, 120007));
+    QCOMPARE(columns.at(0).mouseClicks, quint16(0));
+    QCOMPARE(columns.at(0).keystrokes, quint16(0));
+    QCOMPARE(columns.at(1).mouseClicks, quint16(3));
+    QCOMPARE(columns.at(1).keystrokes, quint16(7));
+    QCOMPARE(columns.totalMouseClicks(), qint64(3));
+    QCOMPARE(columns.totalKeystrokes(), qint64(7));
+
+    columns.clear();
+    columns.append(sample(base + 2, 50009, 120011));
+    columns.append(sample(base + 3, 50010, 120011));
+    QCOMPARE(columns.totalMouseClicks(), qint64(1));
+    QCOMPARE(columns.totalKeystrokes(), qint64(0));
+}
+
+void TestActivityColumns::counterResetRestartsDelta()
+{
+    // 采集重启后计数从 0 重新累计，回退后的值就是增量
+    const qint64 base = QDateTime(QDate(2026, 3, 2), QTime(9, 0)).toSecsSinceEpoch();
+    ActivityColumns columns;
+    columns.append(sample(base, 10, 20));
+    columns.append(sample(base + 1, 12, 25));
+    columns.append(sample(base + 2, 1, 2));
+    QCOMPARE(columns.at(2).mouseClicks, quint16(1));
+    QCOMPARE(columns.at(2).keystrokes, quint16(2));
+    QCOMPARE(columns.totalMouseClicks(), qint64(3));
+    QCOMPARE(columns.totalKeystrokes(), qint64(7));
+}
+
+void TestActivityColumns::fullDayTotals()
+{
+    // 一整天逐秒记录，计数接着前一天累计：求和等于当天累计计数的增长，每条记录约 6 字节
+    const qint64 base = QDateTime(QDate(2026, 3, 2), QTime(0, 0)).toSecsSinceEpoch();
+    const int seconds = 24 * 3600;
+    const int startClicks = 40000;
+    const int startKeystrokes = 300000;
+    ActivityColumns columns;
+    int clicks = startClicks;
+    int keystrokes = startKeystrokes;
+    int active = 0;
+    for (int i = 0; i < seconds; ++i) {
+        clicks += i % 7 == 0 ? 1 : 0;
+        keystrokes += i % 3;
+        const bool isActive = (i / 600) % 4 != 3;
+        active += isActive ? 1 : 0;
+        columns.append(sample(base + i, clicks, keystrokes, isActive));
+    }
+
+    QCOMPARE(columns.size(), seconds);
+    QCOMPARE(columns.activeCount(), active);
+    // 第 0 秒的一次点击已计入作为基准的第一条记录
+    QCOMPARE(columns.totalMouseClicks(), qint64(clicks - (startClicks + 1)));
+    QCOMPARE(columns.totalKeystrokes(), qint64(keystrokes - startKeystrokes));
+    QCOMPARE(columns.at(seconds - 1).timestampSecs, base + seconds - 1);
+
+    const double bytesPerSample = double(columns.memoryUsage()) / seconds;
+    qInfo("%.2f bytes per sample", bytesPerSample);
+    QVERIFY(bytesPerSample < 8.0);
+}
+
+QTEST_GUILESS_MAIN(TestActivityColumns)
+#include "tst_activitycolumns.moc"
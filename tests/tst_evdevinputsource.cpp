@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "core/EvdevInputSource.h"
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief EvdevInputSource 读取管道中录制的 input_event
+ *
+ * 不需要 /dev/input 权限：设备路径指向命名管道，或通过 addFileDescriptor() 加入匿名管道
+ */
+class TestEvdevInputSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void countsRecordedEvents();
+    void readsLargeBatches();
+    void mergesDescriptorsAndDropsClosedPipes();
+
+private:
+    // 按时间顺序生成事件，每个事件比上一个晚 stepMs 毫秒
+    struct Recording {
+        std::vector<input_event> events;
+        qint64 timeMs = 1000;
+
+        void add(unsigned short type, unsigned short code, int value, int stepMs = 0)
+        {
+            timeMs += stepMs;
+            input_event event = {};
+            event.input_event_sec = timeMs / 1000;
+            event.input_event_usec = (timeMs % 1000) * 1000;
+            event.type = type;
+            event.code = code;
+            event.value = value;
+            events.push_back(event);
+        }
+        void key(unsigned short code, int stepMs = 100)
+        {
+            add(EV_KEY, code, 1, stepMs);
+            add(EV_SYN, SYN_REPORT, 0);
+            add(EV_KEY, code, 0, 20);
+            add(EV_SYN, SYN_REPORT, 0);
+        }
+    };
+
+    static void writeAll(int fd, const Recording& recording);
+
+    QTemporaryDir m_dir;
+    QString m_fifoPath;
+    int m_fifoWriter = -1;
+};
+
+void TestEvdevInputSource::init()
+{
+    QVERIFY(m_dir.isValid());
+    m_fifoPath = m_dir.filePath("event0");
+    QFile::remove(m_fifoPath);
+    QCOMPARE(::mkfifo(QFile::encodeName(m_fifoPath).constData(), 0600), 0);
+    // 以读写方式打开写端：没有读者时也不会阻塞，读端也不会因没有写者而读到 EOF
+    m_fifoWriter = ::open(QFile::encodeName(m_fifoPath).constData(), O_RDWR | O_CLOEXEC);
+    QVERIFY(m_fifoWriter >= 0);
+}
+
+void TestEvdevInputSource::cleanup()
+{
+    if (m_fifoWriter >= 0) {
+        ::close(m_fifoWriter);
+        m_fifoWriter = -1;
+    }
+}
+
+void TestEvdevInputSource::writeAll(int fd, const Recording& recording)
+{
+    const char* data = reinterpret_cast<const char*>(recording.events.data());
+    size_t remaining = recording.events.size() * sizeof(input_event);
+    while (remaining > 0) {
+        const ssize_t written = ::write(fd, data, remaining);
+        QVERIFY(written > 0);
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+void TestEvdevInputSource::countsRecordedEvents()
+{
+    EvdevInputSource source(QStringList() << m_fifoPath);
+    QVERIFY(source.open());
+    QCOMPARE(source.deviceCount(), 1);
+    QSignalSpy inputSpy(&source, &InputSource::inputReceived);
+
+    Recording recording;
+    recording.key(KEY_A);
+    recording.key(KEY_B, 150);
+    recording.key(KEY_C, 300);
+    // 自动重复（value 2）与鼠标按钮不算键盘输入
+    recording.add(EV_KEY, KEY_C, 2, 30);
+    recording.add(EV_KEY, BTN_LEFT, 1, 10);
+    recording.add(EV_KEY, BTN_LEFT, 0, 10);
+    recording.add(EV_KEY, BTN_RIGHT, 1, 10);
+    recording.add(EV_KEY, BTN_RIGHT, 0, 10);
+    // 同一帧的 REL_X/REL_Y 合成一次位移：3-4-5
+    recording.add(EV_REL, REL_X, 3, 10);
+    recording.add(EV_REL, REL_Y, -4);
+    recording.add(EV_SYN, SYN_REPORT, 0);
+    recording.add(EV_REL, REL_WHEEL, -2, 10);
+    recording.add(EV_SYN, SYN_REPORT, 0);
+    writeAll(m_fifoWriter, recording);
+
+    source.poll();
+    const InputSource::Counters counters = source.counters();
+    QCOMPARE(counters.keystrokes, 3);
+    QCOMPARE(counters.mouseClicks, 2);
+    QCOMPARE(counters.motionEvents, 2);
+    QCOMPARE(counters.pointerDistance, 5.0);
+    QCOMPARE(counters.wheelTicks, 2);
+    // 按下之间的间隔：170 ms 与 320 ms，第一次按键没有间隔
+    QCOMPARE(counters.keyIntervals.total(), quint64(2));
+    QCOMPARE(counters.keyIntervals.count(LogHistogram::bucketFor(170)), 1u);
+    QCOMPARE(counters.keyIntervals.count(LogHistogram::bucketFor(320)), 1u);
+    QCOMPARE(inputSpy.count(), 1);
+    QVERIFY(source.idleMilliseconds() < 1000);
+}
+
+void TestEvdevInputSource::readsLargeBatches()
+{
+    EvdevInputSource source(QStringList() << m_fifoPath);
+    QVERIFY(source.open());
+
+    // 远多于单次 read() 的批量，须循环读到 EAGAIN 为止；总量不超过管道缓冲区（64 KiB）
+    constexpr int kPresses = 600;
+    Recording recording;
+    for (int i = 0; i < kPresses; ++i) {
+        recording.key(KEY_SPACE, 80);
+    }
+    writeAll(m_fifoWriter, recording);
+
+    // 由 QSocketNotifier 唤醒读取，不调用 poll()
+    QTRY_COMPARE(source.counters().keystrokes, kPresses);
+    QCOMPARE(source.counters().keyIntervals.total(), quint64(kPresses - 1));
+}
+
+void TestEvdevInputSource::mergesDescriptorsAndDropsClosedPipes()
+{
+    EvdevInputSource source(QStringList() << m_fifoPath);
+    QVERIFY(source.open());
+
+    int pipeFds[2];
+    QCOMPARE(::pipe2(pipeFds, O_CLOEXEC), 0);
+    QVERIFY(source.addFileDescriptor(pipeFds[0]));
+    QCOMPARE(source.deviceCount(), 2);
+
+    Recording keyboard;
+    keyboard.key(KEY_X);
+    keyboard.key(KEY_Y);
+    writeAll(pipeFds[1], keyboard);
+
+    Recording mouse;
+    mouse.add(EV_KEY, BTN_MIDDLE, 1);
+    mouse.add(EV_KEY, BTN_MIDDLE, 0, 10);
+    writeAll(m_fifoWriter, mouse);
+
+    ::close(pipeFds[1]);
+    source.poll();
+    QCOMPARE(source.counters().keystrokes, 2);
+    QCOMPARE(source.counters().mouseClicks, 1);
+
+    // 数据读完后的下一次读取遇到 EOF，描述符随之移除，其余设备不受影响
+    source.poll();
+    QCOMPARE(source.deviceCount(), 1);
+    QCOMPARE(source.counters().keystrokes, 2);
+}
+
+QTEST_GUILESS_MAIN(TestEvdevInputSource)
+#include "tst_evdevinputsource.moc"
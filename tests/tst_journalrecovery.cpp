@@ -0,0 +1,315 @@
+#include <QtTest>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include "core/ActivityJournal.h"
+#include "utils/StorageWriter.h"
+#include "utils/StringInternPool.h"
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 段文件尾部损坏、追加失败和进程被强制结束后，重新打开日志能恢复出的记录
+ *
+ * 每条逐秒记录的点击数即其序号，恢复后的记录应是从 0 开始的连续序号，段长度是整条记录的倍数，
+ * 之后追加的记录仍然对齐。
+ */
+class TestJournalRecovery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void tornTail();
+    void truncatedTail();
+    void duplicatedTail();
+    void failedAppendIsRetried_data();
+    void failedAppendIsRetried();
+    void killDuringCommits();
+
+private:
+    QString journalPath(const QString& name) const;
+    void appendSeries(ActivityJournal* journal, int from, int count) const;
+    QList<int> recover(const QString& path) const;
+    static void verifySequence(const QList<int>& sequence, int expected);
+    static void appendRaw(const QString& path, const QByteArray& data);
+
+    QTemporaryDir m_dir;
+    QDate m_day;
+    quint32 m_titleId = 0;
+};
+
+void TestJournalRecovery::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_day = QDate(2026, 3, 2);
+    m_titleId = StringInternPool::titles().intern("recovery.cpp - Editor");
+}
+
+QString TestJournalRecovery::journalPath(const QString& name) const
+{
+    return m_dir.filePath(name + ".journal");
+}
+
+void TestJournalRecovery::appendSeries(ActivityJournal* journal, int from, int count) const
+{
+    const qint64 startMs = QDateTime(m_day, QTime(9, 0)).toMSecsSinceEpoch();
+    for (int i = from; i < from + count; ++i) {
+        ActivityMonitor::ActivityData data;
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(startMs + i * 1000LL);
+        data.mouseClicks = i;
+        data.keystrokes = 2 * i;
+        data.isActive = true;
+        data.windowTitleId = m_titleId;
+        journal->append(data);
+    }
+}
+
+QList<int> TestJournalRecovery::recover(const QString& path) const
+{
+    ActivityJournal journal(path);
+    ActivityJournal::Contents contents;
+    if (!journal.open() || !journal.hasDay(m_day) || !journal.loadDay(m_day, &contents)) {
+        return {};
+    }
+
+    const qint64 size = QFileInfo(journal.segmentPath(m_day)).size();
+    if (size != journal.summary(m_day).bytes ||
+        (size - JournalFormat::HeaderSize) % JournalFormat::RecordSize != 0) {
+        qWarning("segment size %lld does not match the manifest (%lld)", size, journal.summary(m_day).bytes);
+        return {};
+    }
+    if (journal.summary(m_day).records != contents.activities.size()) {
+        qWarning("manifest counts %d records, segment has %lld", journal.summary(m_day).records,
+                 qint64(contents.activities.size()));
+        return {};
+    }
+
+    QList<int> sequence;
+    for (const auto& data : contents.activities) {
+        if (data.keystrokes != 2 * data.mouseClicks || data.windowTitleId != m_titleId) {
+            qWarning("record %d was restored with wrong fields", data.mouseClicks);
+            return {};
+        }
+        sequence.append(data.mouseClicks);
+    }
+    return sequence;
+}
+
+void TestJournalRecovery::verifySequence(const QList<int>& sequence, int expected)
+{
+    QCOMPARE(sequence.size(), expected);
+    for (int i = 0; i < sequence.size(); ++i) {
+        QCOMPARE(sequence.at(i), i);
+    }
+}
+
+void TestJournalRecovery::appendRaw(const QString& path, const QByteArray& data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+void TestJournalRecovery::tornTail()
+{
+    // 追加写到一半时断电：尾部半条记录在打开时截掉，之后的追加从整条记录处接上
+    const QString path = journalPath("torn");
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 0, 100);
+        journal.flush();
+        appendSeries(&journal, 100, 20);
+        QVERIFY(journal.commit());
+    }
+    const QString segment = ActivityJournal(path).segmentPath(m_day);
+    QFile file(segment);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray lastRecord = file.readAll().right(JournalFormat::RecordSize);
+    file.close();
+    appendRaw(segment, lastRecord.left(JournalFormat::RecordSize / 2));
+
+    verifySequence(recover(path), 120);
+
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 120, 30);
+        journal.flush();
+    }
+    verifySequence(recover(path), 150);
+}
+
+void TestJournalRecovery::truncatedTail()
+{
+    // 文件系统只保留了最后一次提交的一部分：清单记录的长度比段长，按段文件重新统计
+    const QString path = journalPath("truncated");
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 0, 100);
+        journal.flush();
+    }
+    const QString segment = ActivityJournal(path).segmentPath(m_day);
+    QVERIFY(QFile::resize(segment, QFileInfo(segment).size() - JournalFormat::RecordSize - 10));
+
+    verifySequence(recover(path), 98);
+
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 98, 12);
+        journal.flush();
+    }
+    verifySequence(recover(path), 110);
+}
+
+void TestJournalRecovery::duplicatedTail()
+{
+    // 尾部重复了一条半记录（没有截断就重试追加的结果）：完整的重复记录仍可读出，半条截掉，之后的追加保持对齐
+    const QString path = journalPath("duplicated");
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 0, 100);
+        journal.flush();
+    }
+    const QString segment = ActivityJournal(path).segmentPath(m_day);
+    QFile file(segment);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray tail = file.readAll().right(JournalFormat::RecordSize);
+    file.close();
+    appendRaw(segment, tail + tail.left(JournalFormat::RecordSize / 2));
+
+    QList<int> sequence = recover(path);
+    QCOMPARE(sequence.size(), 101);
+    QCOMPARE(sequence.takeLast(), 99);
+    verifySequence(sequence, 100);
+
+    {
+        ActivityJournal journal(path);
+        QVERIFY(journal.open());
+        appendSeries(&journal, 100, 10);
+        journal.flush();
+    }
+    sequence = recover(path);
+    QCOMPARE(sequence.size(), 111);
+    sequence.removeAt(100);
+    verifySequence(sequence, 110);
+}
+
+void TestJournalRecovery::failedAppendIsRetried_data()
+{
+    QTest::addColumn<bool>("useWriter");
+    QTest::newRow("synchronous") << false;
+    QTest::newRow("storage writer") << true;
+}
+
+void TestJournalRecovery::failedAppendIsRetried()
+{
+#ifdef Q_OS_UNIX
+    // 用 RLIMIT_FSIZE 让追加只写进去一条半记录（EFBIG），模拟磁盘写满时的部分写入
+    QFETCH(bool, useWriter);
+    const QString path = journalPath(useWriter ? "failed-async" : "failed-sync");
+    StorageWriter writer;
+    ActivityJournal journal(path);
+    QVERIFY(journal.open());
+    if (useWriter) {
+        journal.setStorageWriter(&writer);
+    }
+    appendSeries(&journal, 0, 100);
+    journal.flush();
+    QVERIFY(!journal.hasPendingData());
+    const QString segment = journal.segmentPath(m_day);
+    const qint64 committed = QFileInfo(segment).size();
+    QCOMPARE(committed, journal.summary(m_day).bytes);
+
+    struct rlimit previous;
+    QCOMPARE(::getrlimit(RLIMIT_FSIZE, &previous), 0);
+    const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limited = previous;
+    limited.rlim_cur = committed + JournalFormat::RecordSize + JournalFormat::RecordSize / 2;
+    QCOMPARE(::setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    appendSeries(&journal, 100, 10);
+    bool committedOk = journal.commit();
+    if (useWriter) {
+        writer.waitForDone();
+        committedOk = journal.commit();
+        writer.waitForDone();
+    }
+    const qint64 failedSize = journal.summary(m_day).bytes;
+
+    ::setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, previousHandler);
+
+    // 失败的追加不计入段长度，记录留在内存中；同步写入时段已截回原长度
+    QVERIFY(!committedOk);
+    QCOMPARE(failedSize, committed);
+    QVERIFY(journal.hasPendingData());
+    if (!useWriter) {
+        QCOMPARE(QFileInfo(segment).size(), committed);
+    }
+
+    journal.flush();
+    QVERIFY(!journal.hasPendingData());
+    QCOMPARE(QFileInfo(segment).size(), committed + 10 * JournalFormat::RecordSize);
+    verifySequence(recover(path), 110);
+#else
+    QSKIP("需要 RLIMIT_FSIZE");
+#endif
+}
+
+void TestJournalRecovery::killDuringCommits()
+{
+#ifdef Q_OS_UNIX
+    // 子进程不停追加并提交，随机时刻 SIGKILL；每轮重新打开后序号必须连续，下一轮从恢复出的位置接着写
+    const QString path = journalPath("killed");
+    QRandomGenerator random(20260302);
+    int recovered = 0;
+    for (int round = 0; round < 20; ++round) {
+        const pid_t pid = ::fork();
+        QVERIFY(pid >= 0);
+        if (pid == 0) {
+            ActivityJournal journal(path);
+            if (!journal.open()) {
+                ::_exit(1);
+            }
+            for (int next = recovered; next < 12 * 3600; ++next) {
+                appendSeries(&journal, next, 1);
+                if (next % 5 == 4) {
+                    journal.commit();
+                }
+            }
+            journal.flush();
+            ::_exit(0);
+        }
+
+        QThread::msleep(random.bounded(5, 60));
+        ::kill(pid, SIGKILL);
+        int status = 0;
+        QCOMPARE(::waitpid(pid, &status, 0), pid);
+        QVERIFY(!WIFEXITED(status) || WEXITSTATUS(status) == 0);
+
+        const QList<int> sequence = recover(path);
+        QVERIFY2(sequence.size() >= recovered, qPrintable(QString("round %1").arg(round)));
+        verifySequence(sequence, sequence.size());
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+        recovered = sequence.size();
+    }
+    qInfo("recovered %d records after 20 kills", recovered);
+#else
+    QSKIP("需要 fork()");
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestJournalRecovery)
+#include "tst_journalrecovery.moc"
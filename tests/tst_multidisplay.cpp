@@ -0,0 +1,206 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include "core/ActivityMonitor.h"
+#include "core/DataAnalyzer.h"
+#include "core/WindowTracker.h"
+#include "utils/StorageWriter.h"
+#include <memory>
+#include <sys/resource.h>
+#include <vector>
+
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+
+/**
+ * @brief 多显示器模式的负载测试
+ *
+ * 启动 N 个 Xvfb（环境变量 WELLNESS_LOAD_DISPLAYS，默认 100；设得更小只是冒烟运行，不算通过负载测试），
+ * 每个显示一个 ActivityMonitor（独立 X 连接与采集线程）和 DataAnalyzer，共用一个 StorageWriter，
+ * 与 --displays 模式相同。在每个显示上合成不同次数的按键，检查各会话只计到自己显示上的输入，
+ * 并分别统计 N/4 与 N 个显示时每个显示的 CPU 开销，开销应大致与显示数无关（线性扩展），
+ * 即不超过 N/4 个显示时的 1.5 倍再加 10 ms。
+ * 没有 Xvfb 时跳过。
+ */
+class TestMultiDisplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void scalesLinearly();
+
+private:
+    struct Session {
+        QString display;
+        Display* injector = nullptr;
+        std::unique_ptr<ActivityMonitor> activityMonitor;
+        std::unique_ptr<DataAnalyzer> dataAnalyzer;
+        int lastKeystrokes = 0;
+    };
+
+    static constexpr int kFullDisplays = 100;
+
+    bool startServers(int count);
+    double runSessions(int count);
+    static double cpuSeconds();
+
+    QTemporaryDir m_dir;
+    QString m_xvfb;
+    std::vector<std::unique_ptr<QProcess>> m_servers;
+    QStringList m_displays;
+};
+
+void TestMultiDisplay::initTestCase()
+{
+    m_xvfb = QStandardPaths::findExecutable("Xvfb");
+    if (m_xvfb.isEmpty()) {
+        QSKIP("没有找到 Xvfb");
+    }
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+    WindowTracker::installErrorHandler();
+}
+
+void TestMultiDisplay::cleanupTestCase()
+{
+    for (auto& server : m_servers) {
+        server->terminate();
+        server->waitForFinished(5000);
+    }
+    m_servers.clear();
+}
+
+bool TestMultiDisplay::startServers(int count)
+{
+    // -displayfd 1：由 Xvfb 选择空闲的显示号，就绪后写到标准输出
+    while (m_displays.size() < count) {
+        auto server = std::make_unique<QProcess>();
+        server->start(m_xvfb, QStringList() << "-displayfd" << "1" << "-screen" << "0" << "320x240x24"
+                                            << "-nolisten" << "tcp");
+        if (!server->waitForStarted(5000)) {
+            return false;
+        }
+        while (!server->canReadLine()) {
+            if (!server->waitForReadyRead(10000)) {
+                return false;
+            }
+        }
+        m_displays << ":" + QString::fromLatin1(server->readLine()).trimmed();
+        m_servers.push_back(std::move(server));
+    }
+    return true;
+}
+
+double TestMultiDisplay::cpuSeconds()
+{
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double TestMultiDisplay::runSessions(int count)
+{
+    StorageWriter storageWriter;
+    std::vector<Session> sessions(count);
+    const double cpuStart = cpuSeconds();
+
+    for (int i = 0; i < count; ++i) {
+        Session& session = sessions[i];
+        session.display = m_displays.at(i);
+        session.injector = XOpenDisplay(session.display.toLocal8Bit().constData());
+        if (!session.injector) {
+            qWarning("无法连接 %s", qPrintable(session.display));
+            return -1.0;
+        }
+        session.activityMonitor = std::make_unique<ActivityMonitor>();
+        session.dataAnalyzer = std::make_unique<DataAnalyzer>(
+            m_dir.filePath(QString("activity_log_%1_%2.json").arg(count).arg(i)));
+        session.dataAnalyzer->setStorageWriter(&storageWriter);
+        session.activityMonitor->setDisplayName(session.display);
+        session.activityMonitor->setHighResolutionMode(true);
+        connect(session.activityMonitor.get(), &ActivityMonitor::activityBatchReady,
+                session.dataAnalyzer.get(), &DataAnalyzer::recordActivityBatch);
+        connect(session.activityMonitor.get(), &ActivityMonitor::activityBucketReady,
+                session.dataAnalyzer.get(), &DataAnalyzer::recordActivityBucket);
+        Session* target = &session;
+        connect(session.activityMonitor.get(), &ActivityMonitor::activityDetected, this,
+                [target](const ActivityMonitor::ActivityData& data) { target->lastKeystrokes = data.keystrokes; });
+        session.activityMonitor->start();
+    }
+
+    // 等每个采集线程连上自己的显示后，在第 i 个显示上按 i + 1 次键
+    QTest::qWait(1500);
+    for (int i = 0; i < count; ++i) {
+        Display* injector = sessions[i].injector;
+        const unsigned int keycode = XKeysymToKeycode(injector, XK_a);
+        for (int press = 0; press <= i; ++press) {
+            XTestFakeKeyEvent(injector, keycode, True, CurrentTime);
+            XTestFakeKeyEvent(injector, keycode, False, CurrentTime);
+        }
+        XSync(injector, False);
+    }
+
+    bool delivered = false;
+    QElapsedTimer wait;
+    wait.start();
+    while (!delivered && wait.elapsed() < 30 * 1000) {
+        QTest::qWait(200);
+        delivered = true;
+        for (int i = 0; i < count; ++i) {
+            delivered = delivered && sessions[i].lastKeystrokes >= i + 1;
+        }
+    }
+    // 再运行几个采样周期，统计稳态开销
+    QTest::qWait(3000);
+
+    quint64 overruns = 0;
+    bool isolated = delivered;
+    for (int i = 0; i < count; ++i) {
+        Session& session = sessions[i];
+        if (session.lastKeystrokes != i + 1) {
+            qWarning("%s 计到 %d 次按键，应为 %d", qPrintable(session.display), session.lastKeystrokes, i + 1);
+            isolated = false;
+        }
+        overruns += session.activityMonitor->getCaptureStats().overruns;
+        session.activityMonitor->stop();
+        session.activityMonitor.reset();
+        session.dataAnalyzer.reset();
+        XCloseDisplay(session.injector);
+    }
+    const double cpuPerDisplay = (cpuSeconds() - cpuStart) / count;
+    if (!isolated || overruns > 0) {
+        return -1.0;
+    }
+    return cpuPerDisplay;
+}
+
+void TestMultiDisplay::scalesLinearly()
+{
+    const int requested = qEnvironmentVariableIntValue("WELLNESS_LOAD_DISPLAYS");
+    const int count = requested > 0 ? qMax(4, requested) : kFullDisplays;
+    if (count < kFullDisplays) {
+        qWarning("只启动 %d 个显示（完整负载测试为 %d 个），结果只能作为冒烟测试", count, kFullDisplays);
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY2(startServers(count), "无法启动 Xvfb");
+    qInfo("启动 %d 个 Xvfb 用时 %lld ms", count, timer.elapsed());
+
+    const double small = runSessions(count / 4);
+    QVERIFY2(small >= 0.0, "部分显示的输入没有送达对应的会话");
+    const double full = runSessions(count);
+    QVERIFY2(full >= 0.0, "部分显示的输入没有送达对应的会话");
+    qInfo("每个显示的 CPU 时间：%d 个显示 %.1f ms，%d 个显示 %.1f ms",
+          count / 4, small * 1000.0, count, full * 1000.0);
+
+    // 固定开销（线程、连接）按显示数均摊，单个显示的开销不应随显示数明显增长
+    QVERIFY2(full <= small * 1.5 + 0.01, "单个显示的开销随显示数增长");
+}
+
+QTEST_GUILESS_MAIN(TestMultiDisplay)
+#include "tst_multidisplay.moc"
@@ -0,0 +1,91 @@
+#include <QtTest>
+#include <QSet>
+#include "utils/StringInternPool.h"
+
+/**
+ * @brief 窗口标题池：原文保存、每秒变化的标题归族，以及满了以后回收而不是把新标题记为空
+ */
+class TestStringInternPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void keepsRawTitles();
+    void boundsVolatileTitles();
+    void evictsWhenFull();
+
+private:
+    static QString letters(int value);
+};
+
+QString TestStringInternPool::letters(int value)
+{
+    // 不含数字的唯一标题，避免被归为同一族
+    QString result;
+    do {
+        result.prepend(QChar('a' + value % 26));
+        value /= 26;
+    } while (value > 0);
+    return result;
+}
+
+void TestStringInternPool::keepsRawTitles()
+{
+    StringInternPool& pool = StringInternPool::titles();
+    const quint32 first = pool.intern("Invoice 2024-113.pdf - Viewer");
+    const quint32 second = pool.intern("Invoice 2024-114.pdf - Viewer");
+    QVERIFY(first != StringInternPool::EmptyId);
+    QVERIFY(first != second);
+    QCOMPARE(pool.resolve(first), QString("Invoice 2024-113.pdf - Viewer"));
+    QCOMPARE(pool.resolve(second), QString("Invoice 2024-114.pdf - Viewer"));
+    QCOMPARE(pool.intern("Invoice 2024-113.pdf - Viewer"), first);
+
+    const QString longTitle = QString("x").repeated(3 * StringInternPool::MaxTitleLength);
+    QCOMPARE(pool.resolve(pool.intern(longTitle)).size(), qsizetype(StringInternPool::MaxTitleLength));
+}
+
+void TestStringInternPool::boundsVolatileTitles()
+{
+    // 每秒变化的时钟标题：前几个变体按原文保存，之后沿用同族最近的 ID
+    StringInternPool& pool = StringInternPool::titles();
+    QSet<quint32> ids;
+    quint32 last = StringInternPool::EmptyId;
+    for (int second = 0; second < 600; ++second) {
+        const QString title = QString("Clock %1:%2 - Panel").arg(second / 60, 2, 10, QChar('0'))
+                                  .arg(second % 60, 2, 10, QChar('0'));
+        last = pool.intern(title);
+        ids.insert(last);
+    }
+    QCOMPARE(ids.size(), qsizetype(StringInternPool::MaxTitleVariants));
+    QCOMPARE(pool.resolve(last), QString("Clock 00:07 - Panel"));
+}
+
+void TestStringInternPool::evictsWhenFull()
+{
+    StringInternPool& pool = StringInternPool::titles();
+    const quint32 early = pool.intern("early - Editor");
+    const quint32 kept = pool.intern("kept - Editor");
+
+    quint32 previous = kept;
+    for (int i = 0; i < 3 * StringInternPool::MaxTitles; ++i) {
+        const quint32 id = pool.intern(letters(i) + " - Browser");
+        QVERIFY(id != StringInternPool::EmptyId);
+        QVERIFY(id > previous);
+        previous = id;
+        QVERIFY(pool.size() <= pool.capacity());
+        // 一直在用的标题不会被回收
+        if (i % 1000 == 0) {
+            QCOMPARE(pool.intern("kept - Editor"), kept);
+        }
+    }
+
+    QCOMPARE(pool.resolve(kept), QString("kept - Editor"));
+    QCOMPARE(pool.resolve(early), QString());
+    // 被回收的标题再次出现时分配新 ID，旧 ID 不复用
+    const quint32 again = pool.intern("early - Editor");
+    QVERIFY(again > previous);
+    QCOMPARE(pool.resolve(again), QString("early - Editor"));
+}
+
+QTEST_GUILESS_MAIN(TestStringInternPool)
+#include "tst_stringinternpool.moc"
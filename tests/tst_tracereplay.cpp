@@ -0,0 +1,164 @@
+#include <QtTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include "core/ActivityJournal.h"
+#include "core/ActivityMonitor.h"
+#include "core/DataAnalyzer.h"
+#include "core/HealthEngine.h"
+#include "core/TraceRecorder.h"
+#include "core/TraceReplayer.h"
+#include "utils/StringInternPool.h"
+
+/**
+ * @brief 同一轨迹多次以最大速度回放，整条管线写出的日志目录逐字节一致
+ */
+class TestTraceReplay : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void replayIsDeterministic();
+
+private:
+    void writeTrace(const QString& path, quint64* sampleCount);
+    void replay(const QString& tracePath, const QString& dataPath, quint64* replayedSamples);
+    static QMap<QString, QByteArray> readDirectory(const QString& path);
+
+    QTemporaryDir m_dir;
+};
+
+void TestTraceReplay::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+}
+
+void TestTraceReplay::writeTrace(const QString& path, quint64* sampleCount)
+{
+    TraceRecorder recorder;
+    QVERIFY(recorder.open(path));
+
+    const quint32 titles[] = {
+        StringInternPool::titles().intern("main.cpp - Editor"),
+        StringInternPool::titles().intern("Design review - Browser"),
+        StringInternPool::titles().intern("build - Terminal"),
+    };
+    const quint32 applications[] = {
+        StringInternPool::applications().intern("editor"),
+        StringInternPool::applications().intern("browser"),
+        StringInternPool::applications().intern("terminal"),
+    };
+
+    // 跨越午夜的两段工作：逐秒采样，每隔几分钟切换窗口，中间有一段 20 分钟的离开（采集暂停）
+    QRandomGenerator random(20260302);
+    ActivityCapture::Sample sample;
+    sample.timestampMs = QDateTime(QDate(2026, 3, 2), QTime(22, 30)).toMSecsSinceEpoch();
+    int window = 0;
+    for (int second = 0; second < 3 * 3600; ++second) {
+        if (second == 3600) {
+            sample.timestampMs += 20 * 60 * 1000;
+        }
+        sample.timestampMs += 1000;
+        if (second % 240 == 0) {
+            window = random.bounded(3);
+        }
+        if (random.bounded(4) != 0) {
+            const int keys = random.bounded(6);
+            for (int k = 0; k < keys; ++k) {
+                sample.keyIntervals.addInterval(40 + random.bounded(400));
+            }
+            sample.keystrokes += keys;
+            sample.mouseClicks += random.bounded(10) == 0 ? 1 : 0;
+            sample.motionEvents += random.bounded(30);
+            sample.pointerDistance += random.bounded(200);
+            sample.wheelTicks += random.bounded(20) == 0 ? 3 : 0;
+        }
+        sample.windowTitleId = titles[window];
+        sample.applicationId = applications[window];
+        recorder.record(sample);
+    }
+    *sampleCount = recorder.sampleCount();
+    recorder.close();
+}
+
+void TestTraceReplay::replay(const QString& tracePath, const QString& dataPath, quint64* replayedSamples)
+{
+    // 与 --replay-trace 相同的连接方式，另外接收逐秒批量数据
+    ActivityMonitor activityMonitor;
+    HealthEngine healthEngine;
+    DataAnalyzer dataAnalyzer(dataPath);
+    activityMonitor.setHighResolutionMode(true);
+    connect(&activityMonitor, &ActivityMonitor::activityBucketReady, &healthEngine, &HealthEngine::onActivityBucket);
+    connect(&activityMonitor, &ActivityMonitor::activityBucketReady, &dataAnalyzer, &DataAnalyzer::recordActivityBucket);
+    connect(&activityMonitor, &ActivityMonitor::focusIntervalReady, &dataAnalyzer, &DataAnalyzer::recordFocusInterval);
+    connect(&activityMonitor, &ActivityMonitor::activityBatchReady, &healthEngine, &HealthEngine::onActivityBatch);
+    connect(&activityMonitor, &ActivityMonitor::activityBatchReady, &dataAnalyzer, &DataAnalyzer::recordActivityBatch);
+    connect(&activityMonitor, &ActivityMonitor::breakDetected, &healthEngine, &HealthEngine::onBreakDetected);
+    connect(&activityMonitor, &ActivityMonitor::breakDetected, &dataAnalyzer, &DataAnalyzer::recordBreak);
+
+    TraceReplayer replayer(&activityMonitor);
+    QVERIFY(replayer.open(tracePath));
+    replayer.setSpeed(TraceReplayer::MaxSpeed);
+    QSignalSpy finished(&replayer, &TraceReplayer::finished);
+    replayer.start();
+    QVERIFY(finished.wait(60 * 1000));
+    activityMonitor.flushAggregation();
+    *replayedSamples = replayer.replayedSamples();
+    // dataAnalyzer 析构时追加剩余记录并保存清单
+}
+
+QMap<QString, QByteArray> TestTraceReplay::readDirectory(const QString& path)
+{
+    QMap<QString, QByteArray> files;
+    const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo& entry : entries) {
+        QFile file(entry.filePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            files.insert(entry.fileName(), file.readAll());
+        }
+    }
+    return files;
+}
+
+void TestTraceReplay::replayIsDeterministic()
+{
+    const QString tracePath = m_dir.filePath("session.trace");
+    quint64 recorded = 0;
+    writeTrace(tracePath, &recorded);
+    QCOMPARE(recorded, quint64(3 * 3600));
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QMap<QString, QByteArray>> outputs;
+    for (int run = 0; run < 2; ++run) {
+        const QString dataPath = m_dir.filePath(QString("replay%1.json").arg(run));
+        quint64 replayed = 0;
+        replay(tracePath, dataPath, &replayed);
+        QCOMPARE(replayed, recorded);
+        outputs.append(readDirectory(ActivityJournal::pathForDataFile(dataPath)));
+    }
+    qInfo("两次回放 %llu 个采样共用时 %lld ms", recorded * 2, timer.elapsed());
+
+    // 两天各一个段，另有字典与清单
+    const QMap<QString, QByteArray>& first = outputs.at(0);
+    QVERIFY(first.contains("2026-03-02.seg"));
+    QVERIFY(first.contains("2026-03-03.seg"));
+    QVERIFY(first.contains("strings.dict"));
+    QVERIFY(first.contains("manifest.json"));
+    QCOMPARE(outputs.at(1).keys(), first.keys());
+    for (auto it = first.constBegin(); it != first.constEnd(); ++it) {
+        QVERIFY2(outputs.at(1).value(it.key()) == it.value(), qPrintable(it.key() + " 两次回放的内容不同"));
+    }
+
+    // 回放结果可被正常读回
+    DataAnalyzer analyzer(m_dir.filePath("replay0.json"));
+    const DataAnalyzer::DailyReport report = analyzer.getDailyReport(QDate(2026, 3, 3));
+    QVERIFY(report.totalActiveMinutes > 0);
+}
+
+QTEST_GUILESS_MAIN(TestTraceReplay)
+#include "tst_tracereplay.moc"
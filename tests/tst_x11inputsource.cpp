@@ -0,0 +1,119 @@
+#include <QtTest>
+#include "core/X11InputSource.h"
+
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+
+/**
+ * @brief X11InputSource 的 XInput2 原始事件计数
+ *
+ * 通过另一个 X 连接用 XTest 合成按键、点击和滚轮（与 xdotool 相同的机制），
+ * 检查计数精确。需要可用的 $DISPLAY，例如：xvfb-run -a ctest -R tst_x11inputsource
+ */
+class TestX11InputSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void countsSyntheticInput();
+    void ignoresKeyRepeat();
+
+private:
+    void pressKey(unsigned int keycode, int times);
+    void clickButton(unsigned int button, int times);
+
+    Display* m_injector = nullptr;
+};
+
+void TestX11InputSource::initTestCase()
+{
+    if (qEnvironmentVariableIsEmpty("DISPLAY")) {
+        QSKIP("需要 X 服务器（如 xvfb-run -a ctest）");
+    }
+    m_injector = XOpenDisplay(nullptr);
+    if (!m_injector) {
+        QSKIP("无法连接 $DISPLAY");
+    }
+    int event, error, major, minor;
+    if (!XTestQueryExtension(m_injector, &event, &error, &major, &minor)) {
+        QSKIP("X 服务器不支持 XTest 扩展");
+    }
+}
+
+void TestX11InputSource::cleanupTestCase()
+{
+    if (m_injector) {
+        XCloseDisplay(m_injector);
+        m_injector = nullptr;
+    }
+}
+
+void TestX11InputSource::pressKey(unsigned int keycode, int times)
+{
+    for (int i = 0; i < times; ++i) {
+        XTestFakeKeyEvent(m_injector, keycode, True, CurrentTime);
+        XTestFakeKeyEvent(m_injector, keycode, False, CurrentTime);
+    }
+    XSync(m_injector, False);
+}
+
+void TestX11InputSource::clickButton(unsigned int button, int times)
+{
+    for (int i = 0; i < times; ++i) {
+        XTestFakeButtonEvent(m_injector, button, True, CurrentTime);
+        XTestFakeButtonEvent(m_injector, button, False, CurrentTime);
+    }
+    XSync(m_injector, False);
+}
+
+void TestX11InputSource::countsSyntheticInput()
+{
+    X11InputSource source;
+    QVERIFY(source.open());
+    if (!source.isEventDriven()) {
+        QSKIP("X 服务器不支持 XInput2，输入源处于轮询模式");
+    }
+
+    const unsigned int keycode = XKeysymToKeycode(m_injector, XK_a);
+    QVERIFY(keycode != 0);
+
+    // 轮询只能看到当前状态，两次采样之间的多次按键会漏计；原始事件应逐次计数
+    pressKey(keycode, 25);
+    clickButton(1, 7);
+    clickButton(4, 3); // 滚轮向上
+    XTestFakeRelativeMotionEvent(m_injector, 30, 40, CurrentTime);
+    XSync(m_injector, False);
+
+    QTRY_COMPARE(source.counters().keystrokes, 25);
+    QTRY_COMPARE(source.counters().mouseClicks, 7);
+    QTRY_COMPARE(source.counters().wheelTicks, 3);
+    QTRY_VERIFY(source.counters().motionEvents > 0);
+    QVERIFY(source.counters().keyIntervals.total() > 0);
+}
+
+void TestX11InputSource::ignoresKeyRepeat()
+{
+    X11InputSource source;
+    QVERIFY(source.open());
+    if (!source.isEventDriven()) {
+        QSKIP("X 服务器不支持 XInput2，输入源处于轮询模式");
+    }
+
+    // 按住超过自动重复延迟（默认 660 ms），期间的重复事件带 XIKeyRepeat 标志，一次按住只计一次
+    const unsigned int keycode = XKeysymToKeycode(m_injector, XK_b);
+    XTestFakeKeyEvent(m_injector, keycode, True, CurrentTime);
+    XSync(m_injector, False);
+    QTest::qWait(1000);
+    XTestFakeKeyEvent(m_injector, keycode, False, CurrentTime);
+    XSync(m_injector, False);
+
+    QTRY_COMPARE(source.counters().keystrokes, 1);
+    QTest::qWait(100);
+    QCOMPARE(source.counters().keystrokes, 1);
+}
+
+QTEST_GUILESS_MAIN(TestX11InputSource)
+#include "tst_x11inputsource.moc"